@@ -4,7 +4,15 @@
 #include <chrono>
 #include <cassert>
 #include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <cstdio>
 #include "LOB/Book.h"
+#include "LOB/EngineRunner.h"
+#include "LOB/Journal.h"
+#include "LOB/UringLog.h"
+#include "LOB/CompactJournal.h"
+#include "LOB/ShardedEngine.h"
 #include "LOB/Types.h"
 
 using std::cout;
@@ -17,6 +25,13 @@ using std::uniform_real_distribution;
 using namespace std;
 using namespace std::chrono;
 
+// Counts fills without materializing Trade records (pure matching cost)
+struct TradeCounter : NullEventSink {
+    size_t trades = 0;
+    void on_trade(const Order&, const Order&, PRICE, Volume) { ++trades; }
+};
+using BenchBook = BasicBook<FifoMatching, TradeCounter>;
+
 struct Message {
     enum Type { NEW, CANCEL } type;
     ID order_id;
@@ -124,7 +139,7 @@ struct Metrics {
 };
 
 Metrics run_simulation(const vector<Message>& messages, size_t warmup_iterations = 10000) {
-    Book book(100000); // Large initial pool
+    BenchBook book(100000); // Large initial pool
     Metrics metrics = {};
     
     // Warmup phase
@@ -139,7 +154,7 @@ Metrics run_simulation(const vector<Message>& messages, size_t warmup_iterations
     }
     
     // Reset for actual benchmark
-    Book benchmark_book(100000);
+    BenchBook benchmark_book(100000);
     metrics.messages_processed = 0;
     metrics.orders_placed = 0;
     metrics.orders_cancelled = 0;
@@ -151,10 +166,9 @@ Metrics run_simulation(const vector<Message>& messages, size_t warmup_iterations
     
     for (const auto& msg : messages) {
         if (msg.type == Message::NEW) {
-            const Trades& trades = benchmark_book.place_order(
+            benchmark_book.place_order(
                 msg.order_id, msg.agent_id, msg.order_type,
                 msg.price, msg.volume);
-            metrics.trades_generated += trades.size();
             metrics.orders_placed++;
         } else {
             benchmark_book.delete_order(msg.order_id);
@@ -190,6 +204,7 @@ Metrics run_simulation(const vector<Message>& messages, size_t warmup_iterations
     metrics.total_time_ms = duration.count() / 1e6;
     metrics.avg_latency_ns = static_cast<double>(duration.count()) / metrics.messages_processed;
     metrics.ops_per_sec = 1e9 / metrics.avg_latency_ns;
+    metrics.trades_generated = benchmark_book.get_event_sink().trades;
     metrics.trades_per_sec = (metrics.trades_generated * 1e9) / duration.count();
     metrics.final_resting_orders = benchmark_book.get_resting_orders_count();
     metrics.final_levels = benchmark_book.get_buy_levels_count() + benchmark_book.get_sell_levels_count();
@@ -267,6 +282,275 @@ void print_metrics(const Metrics& m, const SimulationParams& params) {
     cout << "\n" << string(80, '=') << endl;
 }
 
+// End-to-end latency through EngineRunner: the gateway stamps each command at
+// enqueue; a consumer thread records now - stamp at the first fill of each
+// incoming order (the fill reports that follow its ACCEPTED report).
+struct EngineLatency {
+    size_t commands;
+    size_t samples;
+    double total_time_ms;
+    double p50_ns;
+    double p99_ns;
+    double p999_ns;
+    double max_ns;
+};
+
+static uint64_t now_ns() {
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+EngineLatency run_engine_latency(const vector<Message>& messages, WaitStrategy wait_strategy) {
+    CommandRing ingress(1 << 14);
+    ExecutionRing egress(1 << 16);
+    EngineRunner runner(ingress, egress, -1, wait_strategy, 100000);
+
+    ID max_id = 0;
+    for (const auto& msg : messages) max_id = std::max(max_id, msg.order_id);
+    vector<uint64_t> enqueue_ns(max_id + 1, 0);
+    vector<uint64_t> samples;
+    samples.reserve(messages.size());
+
+    std::atomic<bool> gateway_done{false};
+    std::thread consumer([&] {
+        ID incoming = 0;
+        bool sampled = true;
+        unsigned idle_rounds = 0;
+        auto on_report = [&](const ExecutionReport& r) {
+            if (r.exec_type == EXEC_ACCEPTED) {
+                incoming = r.order_id;
+                sampled = false;
+            } else if (!sampled && r.order_id == incoming
+                       && (r.exec_type == EXEC_FILL || r.exec_type == EXEC_PARTIAL_FILL)) {
+                samples.push_back(now_ns() - enqueue_ns[incoming]);
+                sampled = true;
+            }
+        };
+        while (true) {
+            bool finished = gateway_done.load(std::memory_order_acquire) && !runner.is_running();
+            if (egress.consume(on_report) != 0) {
+                idle_rounds = 0;
+            } else if (finished) {
+                break;
+            } else {
+                idle_wait(WAIT_BACKOFF, idle_rounds++);
+            }
+        }
+    });
+
+    runner.start();
+    auto start = steady_clock::now();
+    for (const auto& msg : messages) {
+        Command command{};
+        command.order_id = msg.order_id;
+        if (msg.type == Message::NEW) {
+            command.type = CMD_NEW;
+            command.agent_id = msg.agent_id;
+            command.side = msg.order_type;
+            command.price = msg.price;
+            command.volume = msg.volume;
+            enqueue_ns[msg.order_id] = now_ns();
+        } else {
+            command.type = CMD_CANCEL;
+        }
+        ingress.push(command);
+    }
+    runner.stop();
+    auto end = steady_clock::now();
+    gateway_done.store(true, std::memory_order_release);
+    consumer.join();
+
+    EngineLatency result = {};
+    result.commands = runner.get_processed();
+    result.samples = samples.size();
+    result.total_time_ms = duration_cast<nanoseconds>(end - start).count() / 1e6;
+    if (!samples.empty()) {
+        std::sort(samples.begin(), samples.end());
+        auto pct = [&](double p) {
+            return static_cast<double>(samples[static_cast<size_t>(p * (samples.size() - 1))]);
+        };
+        result.p50_ns = pct(0.50);
+        result.p99_ns = pct(0.99);
+        result.p999_ns = pct(0.999);
+        result.max_ns = static_cast<double>(samples.back());
+    }
+    return result;
+}
+
+void print_engine_latency(const EngineLatency& e, const char* label) {
+    cout << "\n--- Engine Runner (" << label << ") ---" << endl;
+    cout << "  Commands:              " << std::setw(15) << e.commands << endl;
+    cout << "  Throughput:            " << std::setw(15) << std::fixed << std::setprecision(2)
+         << e.commands / (e.total_time_ms * 1e3) << " M cmds/sec" << endl;
+    cout << "  Enqueue-to-Fill Samples:" << std::setw(14) << e.samples << endl;
+    cout << "  p50 Latency:           " << std::setw(15) << std::setprecision(0) << e.p50_ns << " ns" << endl;
+    cout << "  p99 Latency:           " << std::setw(15) << e.p99_ns << " ns" << endl;
+    cout << "  p99.9 Latency:         " << std::setw(15) << e.p999_ns << " ns" << endl;
+    cout << "  Max Latency:           " << std::setw(15) << e.max_ns << " ns" << endl;
+}
+
+// Multi-symbol throughput: messages are spread over `symbol_count` books by
+// order id and pushed through ShardedEngine with 1..N shard threads.
+double run_sharded_throughput(const vector<Message>& messages, size_t symbol_count, size_t shard_count) {
+    ShardedEngine engine(symbol_count, shard_count, WAIT_BACKOFF, {}, 1 << 14, 256);
+    std::atomic<bool> done{false};
+    std::thread consumer([&] {
+        unsigned idle_rounds = 0;
+        while (true) {
+            bool finished = done.load(std::memory_order_acquire);
+            size_t n = 0;
+            for (size_t i = 0; i < engine.get_shard_count(); ++i) {
+                n += engine.get_egress(i).consume([](const ExecutionReport&) {});
+            }
+            if (n != 0) {
+                idle_rounds = 0;
+            } else if (finished) {
+                break;
+            } else {
+                idle_wait(WAIT_BACKOFF, idle_rounds++);
+            }
+        }
+    });
+
+    engine.start();
+    auto start = steady_clock::now();
+    for (const auto& msg : messages) {
+        Command command{};
+        command.order_id = msg.order_id;
+        command.symbol_id = static_cast<uint32_t>(msg.order_id % symbol_count);
+        if (msg.type == Message::NEW) {
+            command.type = CMD_NEW;
+            command.agent_id = msg.agent_id;
+            command.side = msg.order_type;
+            command.price = msg.price;
+            command.volume = msg.volume;
+        } else {
+            command.type = CMD_CANCEL;
+        }
+        engine.submit(command);
+    }
+    engine.stop();
+    auto end = steady_clock::now();
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    return messages.size() / (duration_cast<nanoseconds>(end - start).count() / 1e3);
+}
+
+// Matching-thread cost of journaling: ns per Journal::append with the
+// group-commit thread msyncing in the background
+double run_journal_append(const vector<Message>& messages, const char* path) {
+    std::remove(path);
+    Journal journal(path, messages.size());
+    if (!journal.is_open()) return 0;
+    journal.start();
+    auto start = steady_clock::now();
+    for (const auto& msg : messages) {
+        Command command{};
+        command.type = msg.type == Message::NEW ? CMD_NEW : CMD_CANCEL;
+        command.order_id = msg.order_id;
+        command.agent_id = msg.agent_id;
+        command.side = msg.order_type;
+        command.price = msg.price;
+        command.volume = msg.volume;
+        journal.append(command);
+    }
+    auto end = steady_clock::now();
+    journal.stop();
+    std::remove(path);
+    return static_cast<double>(duration_cast<nanoseconds>(end - start).count()) / messages.size();
+}
+
+// Same through io_uring: the caller copies records and posts full segments,
+// retrying after poll() only when every segment is still in flight
+double run_uring_journal_append(const vector<Message>& messages, const char* path) {
+    double ns_per_cmd = 0;
+    {
+        UringJournal journal(path);
+        if (!journal.is_open()) return 0;
+        auto start = steady_clock::now();
+        for (const auto& msg : messages) {
+            Command command{};
+            command.type = msg.type == Message::NEW ? CMD_NEW : CMD_CANCEL;
+            command.order_id = msg.order_id;
+            command.agent_id = msg.agent_id;
+            command.side = msg.order_type;
+            command.price = msg.price;
+            command.volume = msg.volume;
+            while (!journal.append(command)) {
+                journal.get_log().poll();
+            }
+        }
+        auto end = steady_clock::now();
+        ns_per_cmd = static_cast<double>(duration_cast<nanoseconds>(end - start).count()) / messages.size();
+    }
+    std::remove(path);
+    return ns_per_cmd;
+}
+
+// Compact journal: encode cost, bytes per record and full-file decode rate
+void run_compact_journal(const vector<Message>& messages, const char* path) {
+    std::remove(path);
+    auto start = steady_clock::now();
+    {
+        CompactJournalWriter writer(path);
+        if (!writer.is_open()) return;
+        Timestamp now = 0;
+        for (const auto& msg : messages) {
+            Command command{};
+            command.type = msg.type == Message::NEW ? CMD_NEW : CMD_CANCEL;
+            command.order_id = msg.order_id;
+            command.agent_id = msg.agent_id;
+            command.side = msg.order_type;
+            command.price = msg.price;
+            command.volume = msg.volume;
+            command.timestamp = now += 250;
+            writer.append(command);
+        }
+    }
+    auto mid = steady_clock::now();
+    CompactJournalReader reader(path);
+    Volume checksum = 0;
+    size_t decoded = reader.replay([&](const Command& command) { checksum += command.volume; });
+    auto end = steady_clock::now();
+    std::remove(path);
+
+    cout << "  Compact encode              " << std::setw(15) << std::fixed << std::setprecision(1)
+         << static_cast<double>(duration_cast<nanoseconds>(mid - start).count()) / messages.size() << " ns/cmd" << endl;
+    cout << "  Compact size                " << std::setw(15) << std::setprecision(2)
+         << static_cast<double>(reader.get_file_bytes()) / messages.size() << " bytes/cmd (vs "
+         << sizeof(JournalRecord) << ")" << endl;
+    cout << "  Compact decode              " << std::setw(15)
+         << decoded / (duration_cast<nanoseconds>(end - mid).count() / 1e3) << " M cmds/sec"
+         << (checksum ? "" : " (empty)") << endl;
+}
+
+// Restart cost: save and load a book of `orders` resting orders
+void run_snapshot_restart(size_t orders, const char* path) {
+    BenchBook book(orders);
+    mt19937 rng(7);
+    uniform_int_distribution<PRICE> price_dist(9000, 9999);
+    for (ID id = 1; id <= orders; ++id) {
+        // Bids below 10000, asks above: nothing matches
+        PRICE price = price_dist(rng);
+        book.place_order(id, id % 1000, (id % 2) ? BUY : SELL, (id % 2) ? price : price + 1001, 100);
+    }
+
+    auto t0 = steady_clock::now();
+    book.save_snapshot(path);
+    auto t1 = steady_clock::now();
+    BenchBook restored(orders);
+    bool ok = restored.load_snapshot(path);
+    auto t2 = steady_clock::now();
+    std::remove(path);
+
+    cout << "  Orders:                    " << std::setw(15) << orders << endl;
+    cout << "  Save:                      " << std::setw(15) << std::fixed << std::setprecision(1)
+         << duration_cast<microseconds>(t1 - t0).count() / 1e3 << " ms" << endl;
+    cout << "  Load:                      " << std::setw(15)
+         << duration_cast<microseconds>(t2 - t1).count() / 1e3 << " ms"
+         << (ok && restored.state_hash() == book.state_hash() ? "" : "  (MISMATCH)") << endl;
+}
+
 int main(int argc, char** argv) {
     SimulationParams params;
     
@@ -290,6 +574,39 @@ int main(int argc, char** argv) {
     
     Metrics metrics = run_simulation(messages);
     print_metrics(metrics, params);
+
+    // Threaded run on a prefix: latency is dominated by scheduling when the
+    // gateway, engine and consumer share fewer than three cores
+    vector<Message> engine_messages(messages.begin(),
+                                    messages.begin() + std::min<size_t>(messages.size(), 2000000));
+    WaitStrategy wait_strategy = std::thread::hardware_concurrency() >= 3 ? WAIT_BUSY_SPIN : WAIT_BACKOFF;
+    EngineLatency engine = run_engine_latency(engine_messages, wait_strategy);
+    print_engine_latency(engine, wait_strategy == WAIT_BUSY_SPIN ? "busy spin" : "backoff");
+
+    // One core stays with the gateway; scaling beyond hardware threads is meaningless
+    constexpr size_t SYMBOLS = 2000;
+    size_t max_shards = std::max<size_t>(1, std::min<size_t>(8, std::thread::hardware_concurrency() - 1));
+    cout << "\n--- Sharded Engine (" << SYMBOLS << " symbols) ---" << endl;
+    for (size_t shards = 1; shards <= max_shards; shards *= 2) {
+        cout << "  Shards: " << std::setw(2) << shards << "             " << std::setw(15)
+             << std::fixed << std::setprecision(2)
+             << run_sharded_throughput(engine_messages, SYMBOLS, shards) << " M cmds/sec" << endl;
+    }
+
+    cout << "\n--- Write-Ahead Journal ---" << endl;
+    cout << "  Append (mmap, group msync)  " << std::setw(15) << std::fixed << std::setprecision(1)
+         << run_journal_append(engine_messages, "lob_bench.journal") << " ns/cmd" << endl;
+    double uring_ns = run_uring_journal_append(engine_messages, "lob_bench.uring.journal");
+    if (uring_ns != 0) {
+        cout << "  Append (io_uring segments)  " << std::setw(15) << uring_ns << " ns/cmd" << endl;
+    } else {
+        cout << "  Append (io_uring segments)  " << std::setw(15) << "unavailable" << endl;
+    }
+
+    run_compact_journal(engine_messages, "lob_bench.compact.journal");
+
+    cout << "\n--- Snapshot Restart ---" << endl;
+    run_snapshot_restart(1000000, "lob_bench.snapshot");
     
     return 0;
 }
@@ -2,7 +2,20 @@
 #define LOB_BOOK_H
 
 #include <vector>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <span>
+#include <cstring>
 #include "Level.h"
+#include "LevelList.h"
+#include "StateHash.h"
+#include "Snapshot.h"
+#include "Macros.h"
+#include "MatchingPolicy.h"
+#include "TimingWheel.h"
+#include "TopOfBook.h"
+#include "EventSink.h"
 #include "SlabPool.h"
 #include "FlatHashMap.h"
 
@@ -10,23 +23,77 @@ using PriceLevelMap = FlatHashMap<PRICE, Level*>;
 using Orders = FlatHashMap<ID, Order*>;
 
 /**
- * Book: High-performance limit order book matching engine.
+ * Auction clearing result: the uncross price and the volume it executes.
+ * volume == 0 means the book does not cross (price is then 0).
+ */
+struct UncrossResult {
+    PRICE price;
+    Volume volume;
+};
+
+/**
+ * One row of a depth snapshot: level price, displayed volume and displayed
+ * order count. Hidden orders never show up in a row.
+ */
+struct LevelView {
+    PRICE price;
+    Volume volume;
+    Length order_count;
+};
+
+/** Rows written per side by snapshot_depth */
+struct DepthCount {
+    size_t bids;
+    size_t asks;
+};
+
+/**
+ * Copies up to `depth` displayed levels of a sorted level list, best first;
+ * levels holding only hidden orders are skipped. Never allocates.
+ */
+inline size_t copy_depth(const Level* head, size_t depth, std::span<LevelView> out) {
+    size_t limit = depth < out.size() ? depth : out.size();
+    size_t count = 0;
+    for (const Level* l = head; l && count < limit; l = l->get_next_level()) {
+        if (l->get_displayed_volume() == 0) continue;
+        out[count++] = LevelView{l->get_price(), l->get_displayed_volume(), l->get_displayed_order_number()};
+    }
+    return count;
+}
+
+/**
+ * BasicBook: High-performance limit order book matching engine.
  *
  * Design:
  * - Uses SlabPool for zero-allocation hot path (after warmup)
  * - Raw pointers internally (no shared_ptr overhead)
  * - Intrusive sorted level lists for O(1) best price access
  * - Intrusive FIFO lists at each price level
+ * - Iceberg/hidden orders: Level tracks displayed and hidden volume separately
+ * - Optional self-trade prevention (StpMode), compiled out with LOB_ENABLE_STP=0
+ * - Level allocation chosen at compile time by MatchingPolicy (see MatchingPolicy.h)
+ * - Output delivered inline to a compile-time EventSink (see EventSink.h);
+ *   NullEventSink compiles every hook away
+ * - Auction mode: orders rest without matching (the book may cross) until uncross()
+ * - Stop orders wait in per-side trigger indexes (Levels keyed by trigger price)
+ *   and are activated in trigger order once the last trade price crosses them
+ * - Pegged orders wait in per-reference FIFO peg queues; their price is derived
+ *   from best_bid/best_ask only when an incoming order reaches them, so moving
+ *   the top of book never touches them
+ * - Good-till-time orders are scheduled on a hierarchical TimingWheel when they
+ *   rest; advance_time() expires them through remove_order_from_level
  *
  * Invariants:
  * - best_bid points to highest buy price level (or nullptr)
  * - best_ask points to lowest sell price level (or nullptr)
+ * - best_bid < best_ask outside auction mode
  * - buy_list_head is the highest buy level; levels linked in descending price order
  * - sell_list_head is the lowest sell level; levels linked in ascending price order
  * - All orders/levels owned by internal pools
- * - id_to_order only contains resting orders
+ * - id_to_order only contains resting orders; pending stops are in id_to_stop
  */
-class Book {
+template<typename MatchingPolicy = FifoMatching, typename EventSink = TradeBufferSink>
+class BasicBook {
     private:
         // Price level maps (price -> Level*)
         PriceLevelMap buy_side_limits;
@@ -47,38 +114,293 @@ class Book {
         SlabPool<Order, 16384> order_pool;
         SlabPool<Level, 1024> level_pool;
 
-        // Trade output buffer
-        static constexpr size_t TRADE_BUFFER_SIZE = 16;
-        mutable std::vector<Trade> trade_buffer;
+        // Receives trades, rests and cancels as they happen (see EventSink.h)
+        EventSink event_sink;
+
+        // Self-trade prevention mode (only consulted on same-agent matches)
+        StpMode stp_mode;
+
+        // Call auction phase: orders are collected without matching
+        bool auction_mode;
+
+        // Stop trigger index (trigger price -> Level of pending stops, FIFO per trigger)
+        PriceLevelMap buy_stop_limits;
+        PriceLevelMap sell_stop_limits;
+        Level* buy_stop_head;   // lowest buy trigger (fires when last >= trigger)
+        Level* sell_stop_head;  // highest sell trigger (fires when last <= trigger)
+        Orders id_to_stop;
+        PRICE last_trade_price;
+
+        // Expiry schedule of resting good-till-time orders
+        TimingWheel timer_wheel;
+
+        // Peg queues (FIFO); the Level price is set to the reference on match
+        Level buy_primary_pegs;
+        Level sell_primary_pegs;
+        Level buy_mid_pegs;
+        Level sell_mid_pegs;
+
+        // Cross-thread top of book (optional); written only when it changes
+        TopOfBookPublisher* top_of_book;
+        TopOfBook published_top;
 
         Level* get_or_create_level(PRICE price, bool is_buy);
+        void execute_order(Order* order, bool rest_remainder = true);
+        void match_buy_with_pegs(Order* order);
+        void match_sell_with_pegs(Order* order);
+        bool match_pegs(Order* incoming_order, Level& queue, PRICE price) {
+            queue.set_price(price);
+            return match_fifo(incoming_order, &queue);
+        }
+        Level& peg_queue(const Order* order) {
+            bool is_buy = (order->get_order_type() == BUY);
+            if (order->get_peg_type() == PEG_MIDPOINT) return is_buy ? buy_mid_pegs : sell_mid_pegs;
+            return is_buy ? buy_primary_pegs : sell_primary_pegs;
+        }
+        // Midpoint of the touch; callers check both sides exist
+        std::uint64_t touch_sum() const {
+            return static_cast<std::uint64_t>(best_bid->get_price()) + best_ask->get_price();
+        }
         bool match_against_level(Order* incoming_order, Level* level);
+        void match_best_bid(Order* incoming_order);
+        void match_best_ask(Order* incoming_order);
+        bool match_fifo(Order* incoming_order, Level* level);
+        bool match_pro_rata(Order* incoming_order, Level* level);
+        void fill_resting_order(Order* incoming_order, Order* resting_order, Level* level, Volume fill_volume);
+        void prevent_self_trade(Order* incoming_order, Order* resting_order, Level* level);
+        void cancel_resting_order(Level* level, Order* order);
         void insert_resting_order(Order* order);
         void remove_order_from_level(Order* order, bool is_buy);
+        void replenish_resting_order(Level* level, Order* order) {
+            level->replenish(order);
+            event_sink.on_replenish(*order);
+        }
+        // Zeroes an order already unlinked from its level and reports the volume
+        void report_cancel(Order* order, CancelReason reason) {
+            Volume cancelled = order->get_remaining_volume() + order->get_reserve_volume();
+            order->cancel();
+            event_sink.on_cancel(*order, cancelled, reason);
+        }
+        void release_resting_order(Order* order) {
+            if (LOB_UNLIKELY(order->get_expire_time() != 0)) {
+                timer_wheel.cancel(order);
+            }
+            order_pool.deallocate(order);
+        }
+
+        // Stop order helpers
+        void insert_stop_order(Order* order);
+        void remove_stop_order(Order* order);
+        void activate_triggered_stops();
+        // Deferred during the call phase: uncross() checks once matching resumes
+        void check_stop_triggers() {
+            if (LOB_UNLIKELY((buy_stop_head || sell_stop_head) && !auction_mode)) {
+                activate_triggered_stops();
+            }
+        }
+        // Snapshot helpers (see save_snapshot / load_snapshot)
+        static void save_queue(std::vector<unsigned char>& out, const Level& level, SnapshotQueue queue);
+        static bool valid_snapshot_order(const SnapshotOrder& record, SnapshotQueue queue, PRICE level_price,
+                                         Timestamp now);
+        Order* load_order(const SnapshotOrder& record);
+        // Best level with displayed volume; hidden-only levels above it stay unpublished
+        static const Level* best_displayed(const Level* level) {
+            while (level && LOB_UNLIKELY(level->get_displayed_volume() == 0)) {
+                level = level->get_next_level();
+            }
+            return level;
+        }
+        void publish_top_of_book() {
+            if (!top_of_book) return;
+            TopOfBook top{};
+            if (const Level* bid = best_displayed(best_bid)) {
+                top.bid_price = bid->get_price();
+                top.bid_volume = bid->get_displayed_volume();
+                top.bid_orders = bid->get_displayed_order_number();
+            }
+            if (const Level* ask = best_displayed(best_ask)) {
+                top.ask_price = ask->get_price();
+                top.ask_volume = ask->get_displayed_volume();
+                top.ask_orders = ask->get_displayed_order_number();
+            }
+            top.last_trade_price = last_trade_price;
+            if (top != published_top) {
+                published_top = top;
+                top_of_book->store(top);
+            }
+        }
 
         // Intrusive sorted list helpers
-        void insert_level_sorted_buy(Level* level);
-        void insert_level_sorted_sell(Level* level);
-        void remove_level_from_buy_list(Level* level);
-        void remove_level_from_sell_list(Level* level);
+        void insert_level_sorted_buy(Level* level) { insert_level_descending(buy_list_head, level); }
+        void insert_level_sorted_sell(Level* level) { insert_level_ascending(sell_list_head, level); }
+        void remove_level_from_buy_list(Level* level) { unlink_level(buy_list_head, level); }
+        void remove_level_from_sell_list(Level* level) { unlink_level(sell_list_head, level); }
 
     public:
-        explicit Book(size_t initial_capacity = 1024);
-        ~Book() = default;
+        // Return type of place_* and uncross, chosen by the event sink
+        using Result = decltype(std::declval<const EventSink&>().result());
 
-        Book(const Book&) = delete;
-        Book& operator=(const Book&) = delete;
+        explicit BasicBook(size_t initial_capacity = 1024, EventSink sink = EventSink());
+        ~BasicBook() = default;
 
-        const Trades& place_order(
+        BasicBook(const BasicBook&) = delete;
+        BasicBook& operator=(const BasicBook&) = delete;
+
+        /**
+         * @brief Places a limit order
+         * @param expire_time good-till-time expiry (0 = good-till-cancel); must be
+         *        later than get_time(), otherwise the order is rejected
+         */
+        Result place_order(
             ID order_id,
             ID agent_id,
             OrderType order_type,
             PRICE price,
+            Volume volume,
+            Timestamp expire_time = 0
+        );
+
+        /**
+         * @brief Places an iceberg order showing at most display_volume at a time
+         * When the tip fills it is refilled from the reserve and re-queued at
+         * the tail of its level (no new allocation, no id map insert).
+         */
+        Result place_iceberg_order(
+            ID order_id,
+            ID agent_id,
+            OrderType order_type,
+            PRICE price,
+            Volume volume,
+            Volume display_volume
+        );
+
+        /**
+         * @brief Places an order whose resting volume is never displayed
+         */
+        Result place_hidden_order(
+            ID order_id,
+            ID agent_id,
+            OrderType order_type,
+            PRICE price,
+            Volume volume
+        );
+
+        /**
+         * @brief Places a stop order that becomes a market order once the last
+         * trade price reaches trigger_price (>= for buys, <= for sells).
+         * Unfilled volume of an activated stop-market order is cancelled.
+         * Trades from stops triggered by this call are appended to the result.
+         */
+        Result place_stop_order(
+            ID order_id,
+            ID agent_id,
+            OrderType order_type,
+            PRICE trigger_price,
+            Volume volume
+        );
+
+        /**
+         * @brief Places a stop order that becomes a limit order at limit_price
+         * once the last trade price reaches trigger_price.
+         */
+        Result place_stop_limit_order(
+            ID order_id,
+            ID agent_id,
+            OrderType order_type,
+            PRICE trigger_price,
+            PRICE limit_price,
+            Volume volume
+        );
+
+        /**
+         * @brief Places an order pegged to the same-side best price or the midpoint
+         * The order rests in its peg queue and is priced lazily when matched.
+         * Primary pegs trade after the orders of the level they track; midpoint
+         * pegs trade ahead of the best level. Pegs are dormant while their
+         * reference side is empty. An incoming midpoint peg only takes liquidity
+         * from opposite midpoint pegs, and only when the midpoint is a whole tick.
+         */
+        Result place_pegged_order(
+            ID order_id,
+            ID agent_id,
+            OrderType order_type,
+            PegType peg_type,
             Volume volume
         );
 
+        /**
+         * @brief Places an order that must never take liquidity
+         * Decided by one comparison against the opposite best price before any
+         * allocation; the opposite side's levels are never walked.
+         * @param rested_price if set, receives the price the order rests at
+         *        (may be slid), or 0 if it was rejected
+         */
+        Result place_post_only_order(
+            ID order_id,
+            ID agent_id,
+            OrderType order_type,
+            PRICE price,
+            Volume volume,
+            PostOnlyMode mode = POST_ONLY_REJECT,
+            PRICE* rested_price = nullptr
+        );
+
         void delete_order(ID id);
 
+        /**
+         * @brief Changes price and/or volume of a resting order
+         * Reducing the volume at an unchanged price keeps time priority (icebergs
+         * excepted). Any other change cancels the order and re-enters it with the
+         * same id and attributes, so it may match and loses priority. A pegged
+         * order ignores new_price. Unknown ids and pending stops are ignored.
+         * @param new_volume new remaining volume; 0 cancels the order
+         */
+        Result amend_order(ID id, PRICE new_price, Volume new_volume);
+
+        /**
+         * @brief Advances the book clock and cancels every resting order whose
+         * expire_time <= now. Cost is O(expired), independent of the time step.
+         * @return number of orders expired
+         */
+        size_t advance_time(Timestamp now);
+        Timestamp get_time() const { return timer_wheel.now(); }
+        size_t get_timed_orders_count() const { return timer_wheel.size(); }
+
+        void set_stp_mode(StpMode mode) { stp_mode = mode; }
+        StpMode get_stp_mode() const { return stp_mode; }
+
+        /**
+         * @brief Starts or stops the call phase; while set, orders rest without matching
+         * and stop triggers are not evaluated (uncross() evaluates them on exit)
+         */
+        void set_auction_mode(bool enabled) { auction_mode = enabled; }
+        bool in_auction() const { return auction_mode; }
+
+        /**
+         * @brief Publishes the top of book to `publisher` after every message that
+         * changes it, so other threads can read it via SeqLock::load (nullptr detaches)
+         * @param publisher seqlock owned by the caller; must outlive the book or be detached
+         */
+        void attach_top_of_book(TopOfBookPublisher* publisher) {
+            top_of_book = publisher;
+            published_top = TopOfBook{};
+            if (publisher) publisher->store(published_top);
+            publish_top_of_book();
+        }
+
+        /**
+         * @brief Computes the volume-maximizing clearing price without executing
+         * One merge pass over the crossed part of the bid and ask level lists.
+         */
+        UncrossResult get_indicative_uncross() const;
+
+        /**
+         * @brief Executes the auction at the clearing price and leaves auction mode
+         * Trades report the buy order as incoming and the sell order as matched.
+         * Self-trade prevention does not apply to the uncross.
+         */
+        Result uncross();
+
         PRICE get_spread() const;
         double get_mid_price() const;
         PRICE get_best_buy() const;
@@ -87,16 +409,1340 @@ class Book {
         size_t get_buy_levels_count() const { return buy_side_limits.size(); }
         size_t get_sell_levels_count() const { return sell_side_limits.size(); }
         size_t get_resting_orders_count() const { return id_to_order.size(); }
+        size_t get_pending_stops_count() const { return id_to_stop.size(); }
+        size_t get_pegged_orders_count() const {
+            return buy_primary_pegs.get_order_number() + sell_primary_pegs.get_order_number()
+                 + buy_mid_pegs.get_order_number() + sell_mid_pegs.get_order_number();
+        }
+        PRICE get_last_trade_price() const { return last_trade_price; }
 
         PriceLevelMap& get_buy_limits() { return buy_side_limits; }
         PriceLevelMap& get_sell_limits() { return sell_side_limits; }
         Orders& get_id_to_order() { return id_to_order; }
+        EventSink& get_event_sink() { return event_sink; }
+        const EventSink& get_event_sink() const { return event_sink; }
 
         std::vector<PRICE> get_buy_prices() const;
         std::vector<PRICE> get_sell_prices() const;
 
+        /**
+         * @brief Copies the best `depth` displayed levels of each side into caller buffers
+         * Never allocates; walks `depth` levels per side plus any hidden-only
+         * levels in between, which are left out.
+         * @param depth levels per side (further capped by each span's size)
+         * @param bids receives bid levels, best (highest) first
+         * @param asks receives ask levels, best (lowest) first
+         * @return number of rows written to each span
+         */
+        DepthCount snapshot_depth(size_t depth, std::span<LevelView> bids, std::span<LevelView> asks) const;
+
+        /**
+         * @brief Hash of every resting level and queue position (see StateHash.h)
+         * Peg queues and pending stops are not part of it. O(resting orders).
+         */
+        std::uint64_t state_hash() const { return hash_book(buy_list_head, sell_list_head); }
+
+        /**
+         * @brief Writes every resting level, peg queue and pending stop (in list
+         * and FIFO order) plus the clock, last trade price and modes to `path`
+         * Replaces the file atomically. No events are emitted.
+         * @param journal_position journal records already applied to this book,
+         *        returned by load_snapshot so only the tail needs replaying
+         */
+        bool save_snapshot(const char* path, std::uint64_t journal_position = 0) const;
+
+        /**
+         * @brief Rebuilds the book from save_snapshot output
+         * Levels are appended to their lists in file order and orders pushed
+         * straight onto their queues: no matching, no events. The book must be
+         * empty, with its clock no later than the snapshot's; returns false
+         * otherwise or if the file is invalid, in which case the book is
+         * unchanged. Every record is checked before the
+         * book is touched: framing, enum values, strict price order per list,
+         * each order on the list matching its side, peg type and price (trigger
+         * price for stops), unique ids, and an uncrossed book outside auctions.
+         * @param journal_position receives the saved journal position (optional)
+         */
+        bool load_snapshot(const char* path, std::uint64_t* journal_position = nullptr);
+
         void print() const;
         OrderStatus get_order_status(ID id) const;
 };
 
+// Default price-time priority book reporting trades per call
+using Book = BasicBook<FifoMatching, TradeBufferSink>;
+extern template class BasicBook<FifoMatching, TradeBufferSink>;
+
+template<typename MatchingPolicy, typename EventSink>
+BasicBook<MatchingPolicy, EventSink>::BasicBook(size_t initial_capacity, EventSink sink)
+    : buy_list_head(nullptr),
+      sell_list_head(nullptr),
+      best_bid(buy_list_head),
+      best_ask(sell_list_head),
+      order_pool(initial_capacity),
+      level_pool(initial_capacity / 16),
+      event_sink(std::move(sink)),
+      stp_mode(STP_NONE),
+      auction_mode(false),
+      buy_stop_head(nullptr),
+      sell_stop_head(nullptr),
+      last_trade_price(0),
+      buy_primary_pegs(0),
+      sell_primary_pegs(0),
+      buy_mid_pegs(0),
+      sell_mid_pegs(0),
+      top_of_book(nullptr),
+      published_top{} {
+    buy_side_limits.reserve(256);
+    sell_side_limits.reserve(256);
+    id_to_order.reserve(initial_capacity);
+}
+
+// --- Core methods ---
+
+template<typename MatchingPolicy, typename EventSink>
+typename BasicBook<MatchingPolicy, EventSink>::Result
+BasicBook<MatchingPolicy, EventSink>::place_order(
+    ID order_id,
+    ID agent_id,
+    OrderType order_type,
+    PRICE price,
+    Volume volume,
+    Timestamp expire_time
+) {
+    event_sink.begin();
+
+    if (LOB_UNLIKELY(price <= 0 || volume == 0)) {
+        event_sink.on_reject(order_id, agent_id, order_type, REJECT_INVALID);
+        return event_sink.result();
+    }
+    if (LOB_UNLIKELY(expire_time != 0 && expire_time <= timer_wheel.now())) {
+        event_sink.on_reject(order_id, agent_id, order_type, REJECT_EXPIRED);
+        return event_sink.result();
+    }
+
+    Order* order = order_pool.allocate(
+        order_id, agent_id, order_type, price, volume, volume, ACTIVE
+    );
+    order->set_expire_time(expire_time);
+    event_sink.on_accept(*order);
+    execute_order(order);
+    check_stop_triggers();
+    publish_top_of_book();
+
+    return event_sink.result();
+}
+
+template<typename MatchingPolicy, typename EventSink>
+typename BasicBook<MatchingPolicy, EventSink>::Result
+BasicBook<MatchingPolicy, EventSink>::place_iceberg_order(
+    ID order_id,
+    ID agent_id,
+    OrderType order_type,
+    PRICE price,
+    Volume volume,
+    Volume display_volume
+) {
+    event_sink.begin();
+
+    if (LOB_UNLIKELY(price <= 0 || volume == 0 || display_volume == 0)) {
+        event_sink.on_reject(order_id, agent_id, order_type, REJECT_INVALID);
+        return event_sink.result();
+    }
+
+    // A tip at least as large as the order is just a plain limit order
+    Volume tip = (display_volume < volume) ? display_volume : 0;
+    Order* order = order_pool.allocate(
+        order_id, agent_id, order_type, price, volume, volume, ACTIVE, tip
+    );
+    event_sink.on_accept(*order);
+    execute_order(order);
+    check_stop_triggers();
+    publish_top_of_book();
+
+    return event_sink.result();
+}
+
+template<typename MatchingPolicy, typename EventSink>
+typename BasicBook<MatchingPolicy, EventSink>::Result
+BasicBook<MatchingPolicy, EventSink>::place_hidden_order(
+    ID order_id,
+    ID agent_id,
+    OrderType order_type,
+    PRICE price,
+    Volume volume
+) {
+    event_sink.begin();
+
+    if (LOB_UNLIKELY(price <= 0 || volume == 0)) {
+        event_sink.on_reject(order_id, agent_id, order_type, REJECT_INVALID);
+        return event_sink.result();
+    }
+
+    Order* order = order_pool.allocate(
+        order_id, agent_id, order_type, price, volume, volume, ACTIVE, 0, true
+    );
+    event_sink.on_accept(*order);
+    execute_order(order);
+    check_stop_triggers();
+    publish_top_of_book();
+
+    return event_sink.result();
+}
+
+// Matches a freshly allocated order against the opposite side, then rests or
+// reclaims it. Icebergs take liquidity with their full volume; the reserve is
+// only split off once the order rests.
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::execute_order(Order* order, bool rest_remainder) {
+    if (LOB_UNLIKELY(auction_mode)) {
+        insert_resting_order(order);
+        return;
+    }
+
+    PRICE price = order->get_order_price();
+
+    if (order->get_order_type() == BUY) {
+        if (LOB_UNLIKELY(!sell_primary_pegs.is_empty() || !sell_mid_pegs.is_empty())) {
+            match_buy_with_pegs(order);
+        }
+        while (best_ask && price >= best_ask->get_price() && !order->is_fulfilled()) {
+            match_best_ask(order);
+        }
+    } else {
+        if (LOB_UNLIKELY(!buy_primary_pegs.is_empty() || !buy_mid_pegs.is_empty())) {
+            match_sell_with_pegs(order);
+        }
+        while (best_bid && price <= best_bid->get_price() && !order->is_fulfilled()) {
+            match_best_bid(order);
+        }
+    }
+
+    if (!order->is_fulfilled()) {
+        if (LOB_LIKELY(rest_remainder)) {
+            insert_resting_order(order);
+            return;
+        }
+        report_cancel(order, CANCEL_UNFILLED);
+    }
+    order_pool.deallocate(order);
+}
+
+// Opposite-side pegs are priced here, at match time: midpoint sells at
+// ceil(mid) ahead of the best ask level, primary sells at the best ask price
+// right after that level's own orders. Returns once the order is done or no
+// peg is reachable; the plain level loop in execute_order then finishes.
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::match_buy_with_pegs(Order* order) {
+    PRICE price = order->get_order_price();
+
+    while (!order->is_fulfilled()) {
+        if (!sell_mid_pegs.is_empty() && best_bid && best_ask) {
+            PRICE mid_ask = static_cast<PRICE>((touch_sum() + 1) / 2);
+            if (price >= mid_ask) {
+                match_pegs(order, sell_mid_pegs, mid_ask);
+                continue;
+            }
+        }
+        if (!best_ask || price < best_ask->get_price()
+            || (sell_primary_pegs.is_empty() && sell_mid_pegs.is_empty())) {
+            break;
+        }
+
+        PRICE level_price = best_ask->get_price();
+        match_best_ask(order);
+        if (!order->is_fulfilled() && !sell_primary_pegs.is_empty()) {
+            match_pegs(order, sell_primary_pegs, level_price);
+        }
+    }
+}
+
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::match_sell_with_pegs(Order* order) {
+    PRICE price = order->get_order_price();
+
+    while (!order->is_fulfilled()) {
+        if (!buy_mid_pegs.is_empty() && best_bid && best_ask) {
+            PRICE mid_bid = static_cast<PRICE>(touch_sum() / 2);
+            if (price <= mid_bid) {
+                match_pegs(order, buy_mid_pegs, mid_bid);
+                continue;
+            }
+        }
+        if (!best_bid || price > best_bid->get_price()
+            || (buy_primary_pegs.is_empty() && buy_mid_pegs.is_empty())) {
+            break;
+        }
+
+        PRICE level_price = best_bid->get_price();
+        match_best_bid(order);
+        if (!order->is_fulfilled() && !buy_primary_pegs.is_empty()) {
+            match_pegs(order, buy_primary_pegs, level_price);
+        }
+    }
+}
+
+template<typename MatchingPolicy, typename EventSink>
+typename BasicBook<MatchingPolicy, EventSink>::Result
+BasicBook<MatchingPolicy, EventSink>::place_pegged_order(
+    ID order_id,
+    ID agent_id,
+    OrderType order_type,
+    PegType peg_type,
+    Volume volume
+) {
+    event_sink.begin();
+
+    if (LOB_UNLIKELY(volume == 0 || peg_type == PEG_NONE)) {
+        event_sink.on_reject(order_id, agent_id, order_type, REJECT_INVALID);
+        return event_sink.result();
+    }
+
+    Order* order = order_pool.allocate(
+        order_id, agent_id, order_type, 0, volume, volume, ACTIVE
+    );
+    order->set_peg_type(peg_type);
+    event_sink.on_accept(*order);
+
+    // Midpoint pegs on both sides meet only at a whole-tick midpoint
+    if (peg_type == PEG_MIDPOINT && !auction_mode && best_bid && best_ask
+        && touch_sum() % 2 == 0) {
+        Level& opposite = (order_type == BUY) ? sell_mid_pegs : buy_mid_pegs;
+        if (!opposite.is_empty()) {
+            match_pegs(order, opposite, static_cast<PRICE>(touch_sum() / 2));
+        }
+    }
+
+    if (!order->is_fulfilled()) {
+        peg_queue(order).push_back(order);
+        id_to_order[order->get_order_id()] = order;
+        event_sink.on_rest(*order);
+    } else {
+        order_pool.deallocate(order);
+    }
+    check_stop_triggers();
+    publish_top_of_book();
+
+    return event_sink.result();
+}
+
+template<typename MatchingPolicy, typename EventSink>
+typename BasicBook<MatchingPolicy, EventSink>::Result
+BasicBook<MatchingPolicy, EventSink>::place_post_only_order(
+    ID order_id,
+    ID agent_id,
+    OrderType order_type,
+    PRICE price,
+    Volume volume,
+    PostOnlyMode mode,
+    PRICE* rested_price
+) {
+    event_sink.begin();
+    if (rested_price) *rested_price = 0;
+    if (LOB_UNLIKELY(price <= 0 || volume == 0)) {
+        event_sink.on_reject(order_id, agent_id, order_type, REJECT_INVALID);
+        return event_sink.result();
+    }
+
+    // A crossed book is expected during the call phase; nothing takes liquidity
+    if (!auction_mode) {
+        bool crosses = false;
+        if (order_type == BUY) {
+            if (best_ask && price >= best_ask->get_price()) {
+                crosses = (mode == POST_ONLY_REJECT || best_ask->get_price() == 1);
+                price = best_ask->get_price() - 1;
+            }
+        } else {
+            if (best_bid && price <= best_bid->get_price()) {
+                crosses = (mode == POST_ONLY_REJECT
+                           || best_bid->get_price() == std::numeric_limits<PRICE>::max());
+                price = best_bid->get_price() + 1;
+            }
+        }
+        if (crosses) {
+            event_sink.on_reject(order_id, agent_id, order_type, REJECT_WOULD_CROSS);
+            return event_sink.result();
+        }
+    }
+
+    Order* order = order_pool.allocate(
+        order_id, agent_id, order_type, price, volume, volume, ACTIVE
+    );
+    event_sink.on_accept(*order);
+    insert_resting_order(order);
+    publish_top_of_book();
+
+    if (rested_price) *rested_price = price;
+    return event_sink.result();
+}
+
+template<typename MatchingPolicy, typename EventSink>
+bool BasicBook<MatchingPolicy, EventSink>::match_against_level(Order* incoming_order, Level* level) {
+    if constexpr (MatchingPolicy::pro_rata) {
+        return match_pro_rata(incoming_order, level);
+    } else {
+        return match_fifo(incoming_order, level);
+    }
+}
+
+// Matches against the best level of one side, publishes the level's new
+// state once, and reclaims the level if it was emptied.
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::match_best_ask(Order* incoming_order) {
+    Level* level = best_ask;
+    bool level_empty = match_against_level(incoming_order, level);
+    event_sink.on_level_update(SELL, *level);
+    if (level_empty) {
+        // Unlink from sorted list BEFORE deallocation; best_ask moves to the next level
+        remove_level_from_sell_list(level);
+        sell_side_limits.erase(level->get_price());
+        level_pool.deallocate(level);
+    }
+}
+
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::match_best_bid(Order* incoming_order) {
+    Level* level = best_bid;
+    bool level_empty = match_against_level(incoming_order, level);
+    event_sink.on_level_update(BUY, *level);
+    if (level_empty) {
+        remove_level_from_buy_list(level);
+        buy_side_limits.erase(level->get_price());
+        level_pool.deallocate(level);
+    }
+}
+
+template<typename MatchingPolicy, typename EventSink>
+bool BasicBook<MatchingPolicy, EventSink>::match_fifo(Order* incoming_order, Level* level) {
+    if (LOB_UNLIKELY(!incoming_order || !level || level->is_empty())) {
+        return false;
+    }
+
+    while (level->get_head() && !incoming_order->is_fulfilled()) {
+        Order* resting_order = level->get_head();
+
+#if LOB_ENABLE_STP
+        // Same-agent check stays a single predicted-not-taken branch per fill
+        if (LOB_UNLIKELY(resting_order->get_agent_id() == incoming_order->get_agent_id())
+            && stp_mode != STP_NONE) {
+            prevent_self_trade(incoming_order, resting_order, level);
+            continue;
+        }
+#endif
+
+        Volume resting_remaining = resting_order->get_remaining_volume();
+        Volume incoming_remaining = incoming_order->get_remaining_volume();
+        Volume fill_volume = (resting_remaining < incoming_remaining)
+                            ? resting_remaining
+                            : incoming_remaining;
+
+        resting_order->fill(fill_volume);
+        incoming_order->fill(fill_volume);
+        level->decrease_volume(resting_order, fill_volume);
+
+        event_sink.on_trade(*incoming_order, *resting_order, level->get_price(), fill_volume);
+        last_trade_price = level->get_price();
+
+        if (resting_order->is_fulfilled()) {
+            if (LOB_UNLIKELY(resting_order->get_reserve_volume() != 0)) {
+                // Iceberg tip done: refill from reserve and lose time priority
+                replenish_resting_order(level, resting_order);
+                continue;
+            }
+            resting_order->set_order_status(FULFILLED);
+            Order* fulfilled_order = level->pop_front();
+            id_to_order.erase(fulfilled_order->get_order_id());
+            release_resting_order(fulfilled_order);
+        }
+    }
+
+    return level->is_empty();
+}
+
+// Single pass over the level: optional top-order share, then each displayed
+// order gets floor(size * remaining / displayed_volume). Whatever rounding
+// leaves over (plus hidden volume) is swept FIFO.
+template<typename MatchingPolicy, typename EventSink>
+bool BasicBook<MatchingPolicy, EventSink>::match_pro_rata(Order* incoming_order, Level* level) {
+    if (LOB_UNLIKELY(!incoming_order || !level || level->is_empty())) {
+        return false;
+    }
+
+    // Taking the whole level fills every order in full, whatever the allocation
+    if (incoming_order->get_remaining_volume() >= level->get_total_volume()) {
+        return match_fifo(incoming_order, level);
+    }
+
+    if constexpr (MatchingPolicy::top_order_percent != 0) {
+        Order* top = level->get_head();
+        Volume top_share = incoming_order->get_remaining_volume()
+                           * MatchingPolicy::top_order_percent / 100;
+        if (top_share > top->get_remaining_volume()) {
+            top_share = top->get_remaining_volume();
+        }
+        if (top_share != 0) {
+            fill_resting_order(incoming_order, top, level, top_share);
+        }
+    }
+
+    Volume to_allocate = incoming_order->get_remaining_volume();
+    Volume base = level->get_displayed_volume();
+    if (to_allocate != 0 && base != 0) {
+        // Replenished icebergs move behind `last`; stop there so they are not
+        // allocated twice in the same pass
+        Order* last = level->get_tail();
+        Order* cur = level->get_head();
+        bool done = false;
+        while (cur && !done && !incoming_order->is_fulfilled()) {
+            done = (cur == last);
+            Order* next = cur->get_next_order();
+            if (!cur->is_hidden()) {
+                Volume share = pro_rata_share(cur->get_remaining_volume(), to_allocate, base);
+                if (share > cur->get_remaining_volume()) share = cur->get_remaining_volume();
+                if (share > incoming_order->get_remaining_volume()) {
+                    share = incoming_order->get_remaining_volume();
+                }
+                if (share >= MatchingPolicy::min_allocation && share != 0) {
+                    fill_resting_order(incoming_order, cur, level, share);
+                }
+            }
+            cur = next;
+        }
+    }
+
+    return match_fifo(incoming_order, level);
+}
+
+// Fills `resting_order` anywhere in `level` (pro-rata path). May unlink it.
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::fill_resting_order(
+    Order* incoming_order, Order* resting_order, Level* level, Volume fill_volume) {
+#if LOB_ENABLE_STP
+    if (LOB_UNLIKELY(resting_order->get_agent_id() == incoming_order->get_agent_id())
+        && stp_mode != STP_NONE) {
+        prevent_self_trade(incoming_order, resting_order, level);
+        return;
+    }
+#endif
+
+    resting_order->fill(fill_volume);
+    incoming_order->fill(fill_volume);
+    level->decrease_volume(resting_order, fill_volume);
+
+    event_sink.on_trade(*incoming_order, *resting_order, level->get_price(), fill_volume);
+    last_trade_price = level->get_price();
+
+    if (resting_order->is_fulfilled()) {
+        if (LOB_UNLIKELY(resting_order->get_reserve_volume() != 0)) {
+            replenish_resting_order(level, resting_order);
+            return;
+        }
+        resting_order->set_order_status(FULFILLED);
+        level->erase(resting_order);
+        id_to_order.erase(resting_order->get_order_id());
+        release_resting_order(resting_order);
+    }
+}
+
+// Resolves a self-match against `resting_order` in `level`. Cancelling the incoming order
+// zeroes its remaining volume, which ends the matching loops in place_order.
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::prevent_self_trade(Order* incoming_order, Order* resting_order, Level* level) {
+    switch (stp_mode) {
+        case STP_CANCEL_NEWEST:
+            report_cancel(incoming_order, CANCEL_SELF_TRADE);
+            break;
+        case STP_CANCEL_OLDEST:
+            cancel_resting_order(level, resting_order);
+            break;
+        case STP_CANCEL_BOTH:
+            cancel_resting_order(level, resting_order);
+            report_cancel(incoming_order, CANCEL_SELF_TRADE);
+            break;
+        case STP_DECREMENT: {
+            Volume resting_remaining = resting_order->get_remaining_volume();
+            Volume incoming_remaining = incoming_order->get_remaining_volume();
+            Volume decrement = (resting_remaining < incoming_remaining)
+                               ? resting_remaining
+                               : incoming_remaining;
+            level->decrease_volume(resting_order, decrement);
+            incoming_order->reduce(decrement);
+            resting_order->reduce(decrement);
+            event_sink.on_cancel(*incoming_order, decrement, CANCEL_SELF_TRADE);
+            event_sink.on_cancel(*resting_order, decrement, CANCEL_SELF_TRADE);
+            if (resting_order->get_remaining_volume() == 0) {
+                if (resting_order->get_reserve_volume() != 0) {
+                    replenish_resting_order(level, resting_order);
+                } else {
+                    level->erase(resting_order);
+                    id_to_order.erase(resting_order->get_order_id());
+                    release_resting_order(resting_order);
+                }
+            }
+            break;
+        }
+        case STP_NONE:
+            break;
+    }
+}
+
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::cancel_resting_order(Level* level, Order* order) {
+    level->erase(order);
+    report_cancel(order, CANCEL_SELF_TRADE);
+    id_to_order.erase(order->get_order_id());
+    release_resting_order(order);
+}
+
+// Walks both sides as if matching level totals against each other; the
+// crossed volume is the maximum executable volume. Any price between the last
+// crossed ask and bid executes it: the side with surplus sets the price, and a
+// balanced book clears at the midpoint (rounded down).
+template<typename MatchingPolicy, typename EventSink>
+UncrossResult BasicBook<MatchingPolicy, EventSink>::get_indicative_uncross() const {
+    Level* bid = buy_list_head;
+    Level* ask = sell_list_head;
+    Volume bid_left = bid ? bid->get_total_volume() : 0;
+    Volume ask_left = ask ? ask->get_total_volume() : 0;
+    Volume executed = 0;
+    PRICE last_bid = 0;
+    PRICE last_ask = 0;
+
+    while (bid && ask && bid->get_price() >= ask->get_price()) {
+        Volume fill_volume = (bid_left < ask_left) ? bid_left : ask_left;
+        executed += fill_volume;
+        bid_left -= fill_volume;
+        ask_left -= fill_volume;
+        last_bid = bid->get_price();
+        last_ask = ask->get_price();
+        if (bid_left == 0) {
+            bid = bid->get_next_level();
+            bid_left = bid ? bid->get_total_volume() : 0;
+        }
+        if (ask_left == 0) {
+            ask = ask->get_next_level();
+            ask_left = ask ? ask->get_total_volume() : 0;
+        }
+    }
+
+    if (executed == 0) {
+        return UncrossResult{0, 0};
+    }
+
+    PRICE price;
+    if (bid && bid->get_price() == last_bid) {
+        price = last_bid;   // unfilled demand at the last crossed bid
+    } else if (ask && ask->get_price() == last_ask) {
+        price = last_ask;   // unfilled supply at the last crossed ask
+    } else {
+        price = last_ask + (last_bid - last_ask) / 2;
+    }
+    return UncrossResult{price, executed};
+}
+
+template<typename MatchingPolicy, typename EventSink>
+typename BasicBook<MatchingPolicy, EventSink>::Result
+BasicBook<MatchingPolicy, EventSink>::uncross() {
+    event_sink.begin();
+    auction_mode = false;
+
+    UncrossResult result = get_indicative_uncross();
+    Volume remaining = result.volume;
+
+    // Same levels the indicative pass crossed, consumed in price-time order
+    while (remaining != 0) {
+        Order* buy_order = best_bid->get_head();
+        Order* sell_order = best_ask->get_head();
+        Volume fill_volume = buy_order->get_remaining_volume();
+        if (sell_order->get_remaining_volume() < fill_volume) {
+            fill_volume = sell_order->get_remaining_volume();
+        }
+        if (remaining < fill_volume) {
+            fill_volume = remaining;
+        }
+        remaining -= fill_volume;
+
+        buy_order->fill(fill_volume);
+        sell_order->fill(fill_volume);
+        best_bid->decrease_volume(buy_order, fill_volume);
+        best_ask->decrease_volume(sell_order, fill_volume);
+
+        event_sink.on_trade(*buy_order, *sell_order, result.price, fill_volume);
+        last_trade_price = result.price;
+
+        // remove_order_from_level publishes the level update itself
+        if (buy_order->is_fulfilled() && buy_order->get_reserve_volume() == 0) {
+            remove_order_from_level(buy_order, true);
+            buy_order->set_order_status(FULFILLED);
+            id_to_order.erase(buy_order->get_order_id());
+            release_resting_order(buy_order);
+        } else {
+            if (LOB_UNLIKELY(buy_order->is_fulfilled())) {
+                replenish_resting_order(best_bid, buy_order);
+            }
+            event_sink.on_level_update(BUY, *best_bid);
+        }
+        if (sell_order->is_fulfilled() && sell_order->get_reserve_volume() == 0) {
+            remove_order_from_level(sell_order, false);
+            sell_order->set_order_status(FULFILLED);
+            id_to_order.erase(sell_order->get_order_id());
+            release_resting_order(sell_order);
+        } else {
+            if (LOB_UNLIKELY(sell_order->is_fulfilled())) {
+                replenish_resting_order(best_ask, sell_order);
+            }
+            event_sink.on_level_update(SELL, *best_ask);
+        }
+    }
+
+    check_stop_triggers();
+    publish_top_of_book();
+    return event_sink.result();
+}
+
+template<typename MatchingPolicy, typename EventSink>
+typename BasicBook<MatchingPolicy, EventSink>::Result
+BasicBook<MatchingPolicy, EventSink>::place_stop_order(
+    ID order_id,
+    ID agent_id,
+    OrderType order_type,
+    PRICE trigger_price,
+    Volume volume
+) {
+    event_sink.begin();
+
+    if (LOB_UNLIKELY(trigger_price <= 0 || volume == 0)) {
+        event_sink.on_reject(order_id, agent_id, order_type, REJECT_INVALID);
+        return event_sink.result();
+    }
+
+    Order* order = order_pool.allocate(
+        order_id, agent_id, order_type, 0, volume, volume, PENDING
+    );
+    order->set_trigger_price(trigger_price);
+    event_sink.on_accept(*order);
+    insert_stop_order(order);
+    check_stop_triggers();
+    publish_top_of_book();
+
+    return event_sink.result();
+}
+
+template<typename MatchingPolicy, typename EventSink>
+typename BasicBook<MatchingPolicy, EventSink>::Result
+BasicBook<MatchingPolicy, EventSink>::place_stop_limit_order(
+    ID order_id,
+    ID agent_id,
+    OrderType order_type,
+    PRICE trigger_price,
+    PRICE limit_price,
+    Volume volume
+) {
+    event_sink.begin();
+
+    if (LOB_UNLIKELY(trigger_price <= 0 || limit_price <= 0 || volume == 0)) {
+        event_sink.on_reject(order_id, agent_id, order_type, REJECT_INVALID);
+        return event_sink.result();
+    }
+
+    Order* order = order_pool.allocate(
+        order_id, agent_id, order_type, limit_price, volume, volume, PENDING
+    );
+    order->set_trigger_price(trigger_price);
+    event_sink.on_accept(*order);
+    insert_stop_order(order);
+    check_stop_triggers();
+    publish_top_of_book();
+
+    return event_sink.result();
+}
+
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::insert_stop_order(Order* order) {
+    PRICE trigger = order->get_trigger_price();
+    bool is_buy = (order->get_order_type() == BUY);
+    PriceLevelMap& stops = is_buy ? buy_stop_limits : sell_stop_limits;
+
+    Level* level;
+    auto it = stops.find(trigger);
+    if (it != stops.end()) {
+        level = it->second;
+    } else {
+        level = level_pool.allocate(trigger);
+        stops[trigger] = level;
+        if (is_buy) {
+            insert_level_ascending(buy_stop_head, level);
+        } else {
+            insert_level_descending(sell_stop_head, level);
+        }
+    }
+    level->push_back(order);
+
+    id_to_stop[order->get_order_id()] = order;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::remove_stop_order(Order* order) {
+    bool is_buy = (order->get_order_type() == BUY);
+    PriceLevelMap& stops = is_buy ? buy_stop_limits : sell_stop_limits;
+
+    auto it = stops.find(order->get_trigger_price());
+    Level* level = it->second;
+    level->erase(order);
+    if (level->is_empty()) {
+        unlink_level(is_buy ? buy_stop_head : sell_stop_head, level);
+        stops.erase(it);
+        level_pool.deallocate(level);
+    }
+    id_to_stop.erase(order->get_order_id());
+}
+
+// Pops stops from the front of the trigger indexes while the last trade price
+// crosses them: buy stops first, lowest trigger first, FIFO per trigger. Each
+// activation may trade and move the last price, so the heads are re-checked;
+// untriggered stops are never visited.
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::activate_triggered_stops() {
+    while (true) {
+        Order* stop;
+        if (buy_stop_head && last_trade_price >= buy_stop_head->get_price()) {
+            stop = buy_stop_head->get_head();
+        } else if (sell_stop_head && last_trade_price != 0
+                   && last_trade_price <= sell_stop_head->get_price()) {
+            stop = sell_stop_head->get_head();
+        } else {
+            break;
+        }
+
+        remove_stop_order(stop);
+        stop->set_order_status(ACTIVE);
+
+        if (stop->get_order_price() == 0) {
+            // Stop-market: sweep at any price, never rest
+            stop->set_order_price(stop->get_order_type() == BUY
+                                  ? std::numeric_limits<PRICE>::max()
+                                  : 1);
+            execute_order(stop, false);
+        } else {
+            execute_order(stop);
+        }
+    }
+}
+
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::delete_order(ID id) {
+    auto it = id_to_order.find(id);
+    if (it == id_to_order.end()) {
+        if (LOB_UNLIKELY(!id_to_stop.empty())) {
+            auto stop_it = id_to_stop.find(id);
+            if (stop_it != id_to_stop.end()) {
+                Order* stop = stop_it->second;
+                remove_stop_order(stop);
+                report_cancel(stop, CANCEL_USER);
+                order_pool.deallocate(stop);
+            }
+        }
+        return;
+    }
+
+    Order* order = it->second;
+    if (order->get_order_status() == ACTIVE) {
+        bool is_buy = (order->get_order_type() == BUY);
+        remove_order_from_level(order, is_buy);
+        report_cancel(order, CANCEL_USER);
+        id_to_order.erase(it);
+        release_resting_order(order);
+        publish_top_of_book();
+    } else {
+        id_to_order.erase(it);
+    }
+}
+
+template<typename MatchingPolicy, typename EventSink>
+typename BasicBook<MatchingPolicy, EventSink>::Result
+BasicBook<MatchingPolicy, EventSink>::amend_order(ID id, PRICE new_price, Volume new_volume) {
+    auto it = id_to_order.find(id);
+    if (LOB_UNLIKELY(it == id_to_order.end())) {
+        // Unknown or a pending stop (not in id_to_order): left untouched
+        event_sink.begin();
+        return event_sink.result();
+    }
+    if (LOB_UNLIKELY(new_volume == 0)) {
+        delete_order(id);
+        event_sink.begin();
+        return event_sink.result();
+    }
+
+    Order* order = it->second;
+    bool is_peg = (order->get_peg_type() != PEG_NONE);
+    if ((is_peg || new_price == order->get_order_price()) && !order->is_iceberg()
+        && new_volume <= order->get_remaining_volume()) {
+        event_sink.begin();
+        Volume delta = order->get_remaining_volume() - new_volume;
+        if (delta != 0) {
+            bool is_buy = (order->get_order_type() == BUY);
+            Level* level = is_peg ? &peg_queue(order)
+                                  : (is_buy ? buy_side_limits : sell_side_limits).find(order->get_order_price())->second;
+            level->decrease_volume(order, delta);
+            order->reduce(delta);
+            event_sink.on_cancel(*order, delta, CANCEL_USER);
+            if (!is_peg && !order->is_hidden()) {
+                event_sink.on_level_update(is_buy ? BUY : SELL, *level);
+                publish_top_of_book();
+            }
+        }
+        return event_sink.result();
+    }
+
+    // Cancel/replace with the original attributes
+    ID agent_id = order->get_agent_id();
+    OrderType order_type = order->get_order_type();
+    PegType peg_type = order->get_peg_type();
+    Volume display_volume = order->get_display_volume();
+    bool hidden = order->is_hidden();
+    Timestamp expire_time = order->get_expire_time();
+    delete_order(id);
+
+    if (is_peg) {
+        return place_pegged_order(id, agent_id, order_type, peg_type, new_volume);
+    }
+    if (display_volume != 0) {
+        return place_iceberg_order(id, agent_id, order_type, new_price, new_volume, display_volume);
+    }
+    if (hidden) {
+        return place_hidden_order(id, agent_id, order_type, new_price, new_volume);
+    }
+    return place_order(id, agent_id, order_type, new_price, new_volume, expire_time);
+}
+
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::insert_resting_order(Order* order) {
+    PRICE price = order->get_order_price();
+    bool is_buy = (order->get_order_type() == BUY);
+
+    if (LOB_UNLIKELY(order->is_iceberg())) {
+        order->hold_reserve();
+    }
+
+    Level* level = get_or_create_level(price, is_buy);
+    level->push_back(order);
+    if (LOB_LIKELY(!order->is_hidden())) {
+        event_sink.on_level_update(is_buy ? BUY : SELL, *level);
+    }
+
+    id_to_order[order->get_order_id()] = order;
+
+    if (LOB_UNLIKELY(order->get_expire_time() != 0)) {
+        timer_wheel.schedule(order);
+    }
+    event_sink.on_rest(*order);
+}
+
+template<typename MatchingPolicy, typename EventSink>
+size_t BasicBook<MatchingPolicy, EventSink>::advance_time(Timestamp now) {
+    size_t expired = 0;
+    timer_wheel.advance(now, [this, &expired](Order* order) {
+        // Already unlinked from the wheel: take the plain cancel path
+        remove_order_from_level(order, order->get_order_type() == BUY);
+        report_cancel(order, CANCEL_EXPIRED);
+        id_to_order.erase(order->get_order_id());
+        order_pool.deallocate(order);
+        ++expired;
+    });
+    if (expired != 0) publish_top_of_book();
+    return expired;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+Level* BasicBook<MatchingPolicy, EventSink>::get_or_create_level(PRICE price, bool is_buy) {
+    PriceLevelMap& limits = is_buy ? buy_side_limits : sell_side_limits;
+    auto it = limits.find(price);
+
+    if (it != limits.end()) {
+        return it->second;
+    }
+
+    Level* level = level_pool.allocate(price);
+    limits[price] = level;
+
+    // Insert into sorted intrusive list
+    if (is_buy) {
+        insert_level_sorted_buy(level);
+    } else {
+        insert_level_sorted_sell(level);
+    }
+
+    return level;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::remove_order_from_level(Order* order, bool is_buy) {
+    if (LOB_UNLIKELY(order->get_peg_type() != PEG_NONE)) {
+        peg_queue(order).erase(order);
+        order->set_order_status(DELETED);
+        return;
+    }
+
+    PRICE price = order->get_order_price();
+    PriceLevelMap& limits = is_buy ? buy_side_limits : sell_side_limits;
+
+    auto it = limits.find(price);
+    if (it == limits.end()) {
+        return;
+    }
+
+    Level* level = it->second;
+    level->erase(order);
+    order->set_order_status(DELETED);
+    if (LOB_LIKELY(!order->is_hidden())) {
+        event_sink.on_level_update(is_buy ? BUY : SELL, *level);
+    }
+
+    if (level->is_empty()) {
+        // Unlink from sorted list BEFORE deallocation
+        if (is_buy) {
+            remove_level_from_buy_list(level);
+        } else {
+            remove_level_from_sell_list(level);
+        }
+        limits.erase(it);
+        level_pool.deallocate(level);
+    }
+}
+
+template<typename MatchingPolicy, typename EventSink>
+PRICE BasicBook<MatchingPolicy, EventSink>::get_best_buy() const {
+    return best_bid ? best_bid->get_price() : 0;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+PRICE BasicBook<MatchingPolicy, EventSink>::get_best_sell() const {
+    return best_ask ? best_ask->get_price() : 0;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+PRICE BasicBook<MatchingPolicy, EventSink>::get_spread() const {
+    PRICE bid = get_best_buy();
+    PRICE ask = get_best_sell();
+    if (bid == 0 || ask == 0 || ask <= bid) return 0;
+    return ask - bid;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+double BasicBook<MatchingPolicy, EventSink>::get_mid_price() const {
+    PRICE bid = get_best_buy();
+    PRICE ask = get_best_sell();
+    if (bid == 0 || ask == 0) return 0.0;
+    return (bid + ask) / 2.0;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+std::vector<PRICE> BasicBook<MatchingPolicy, EventSink>::get_buy_prices() const {
+    std::vector<PRICE> result;
+    // Walk intrusive list (already sorted descending)
+    for (Level* l = buy_list_head; l; l = l->get_next_level()) {
+        if (!l->is_empty()) {
+            result.push_back(l->get_price());
+        }
+    }
+    return result;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+std::vector<PRICE> BasicBook<MatchingPolicy, EventSink>::get_sell_prices() const {
+    std::vector<PRICE> result;
+    // Walk intrusive list (already sorted ascending)
+    for (Level* l = sell_list_head; l; l = l->get_next_level()) {
+        if (!l->is_empty()) {
+            result.push_back(l->get_price());
+        }
+    }
+    return result;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+DepthCount BasicBook<MatchingPolicy, EventSink>::snapshot_depth(
+    size_t depth, std::span<LevelView> bids, std::span<LevelView> asks) const {
+    return DepthCount{copy_depth(buy_list_head, depth, bids), copy_depth(sell_list_head, depth, asks)};
+}
+
+// --- Snapshot ---
+
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::save_queue(
+    std::vector<unsigned char>& out, const Level& level, SnapshotQueue queue) {
+    SnapshotLevel header{};
+    header.order_count = level.get_order_number();
+    header.price = (queue == SNAP_PEG_QUEUE) ? 0 : level.get_price();
+    header.queue = queue;
+    size_t offset = out.size();
+    out.resize(offset + sizeof(SnapshotLevel) + header.order_count * sizeof(SnapshotOrder));
+    std::memcpy(out.data() + offset, &header, sizeof(header));
+    offset += sizeof(header);
+
+    for (const Order* o = level.get_head(); o; o = o->get_next_order()) {
+        SnapshotOrder record{};
+        record.order_id = o->get_order_id();
+        record.agent_id = o->get_agent_id();
+        record.initial_volume = o->get_initial_volume();
+        record.remaining_volume = o->get_remaining_volume();
+        record.reserve_volume = o->get_reserve_volume();
+        record.display_volume = o->get_display_volume();
+        record.expire_time = o->get_expire_time();
+        record.price = o->get_order_price();
+        record.trigger_price = o->get_trigger_price();
+        record.side = static_cast<std::uint8_t>(o->get_order_type());
+        record.hidden = o->is_hidden();
+        record.peg_type = static_cast<std::uint8_t>(o->get_peg_type());
+        record.status = static_cast<std::uint8_t>(o->get_order_status());
+        std::memcpy(out.data() + offset, &record, sizeof(record));
+        offset += sizeof(record);
+    }
+}
+
+template<typename MatchingPolicy, typename EventSink>
+bool BasicBook<MatchingPolicy, EventSink>::save_snapshot(const char* path, std::uint64_t journal_position) const {
+    size_t levels = buy_side_limits.size() + sell_side_limits.size() + 4
+                    + buy_stop_limits.size() + sell_stop_limits.size();
+    size_t orders = id_to_order.size() + id_to_stop.size();
+
+    SnapshotHeader header{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.last_trade_price = last_trade_price;
+    header.journal_position = journal_position;
+    header.time = timer_wheel.now();
+    header.level_count = levels;
+    header.order_count = orders;
+    header.stp_mode = static_cast<std::uint8_t>(stp_mode);
+    header.auction_mode = auction_mode;
+
+    std::vector<unsigned char> out;
+    out.reserve(sizeof(header) + levels * sizeof(SnapshotLevel) + orders * sizeof(SnapshotOrder));
+    out.resize(sizeof(header));
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    for (const Level* l = buy_list_head; l; l = l->get_next_level()) save_queue(out, *l, SNAP_BID_LEVEL);
+    for (const Level* l = sell_list_head; l; l = l->get_next_level()) save_queue(out, *l, SNAP_ASK_LEVEL);
+    save_queue(out, buy_primary_pegs, SNAP_PEG_QUEUE);
+    save_queue(out, sell_primary_pegs, SNAP_PEG_QUEUE);
+    save_queue(out, buy_mid_pegs, SNAP_PEG_QUEUE);
+    save_queue(out, sell_mid_pegs, SNAP_PEG_QUEUE);
+    for (const Level* l = buy_stop_head; l; l = l->get_next_level()) save_queue(out, *l, SNAP_BUY_STOP);
+    for (const Level* l = sell_stop_head; l; l = l->get_next_level()) save_queue(out, *l, SNAP_SELL_STOP);
+
+    return write_file_atomically(path, out.data(), out.size());
+}
+
+// One order record must fit the queue it was saved in: side and peg type of
+// its list, its level's price (trigger price for stops), and a live status
+template<typename MatchingPolicy, typename EventSink>
+bool BasicBook<MatchingPolicy, EventSink>::valid_snapshot_order(
+    const SnapshotOrder& record, SnapshotQueue queue, PRICE level_price, Timestamp now) {
+    if (record.side > SELL || record.peg_type > PEG_MIDPOINT || record.hidden > 1
+        || record.remaining_volume == 0
+        || (record.reserve_volume != 0 && (record.display_volume == 0 || record.hidden))) {
+        return false;
+    }
+    bool is_buy = (record.side == BUY);
+    bool live = (record.expire_time == 0 || record.expire_time > now);
+    switch (queue) {
+        case SNAP_BID_LEVEL:
+        case SNAP_ASK_LEVEL:
+            return record.status == ACTIVE && record.peg_type == PEG_NONE && live
+                && record.price == level_price && is_buy == (queue == SNAP_BID_LEVEL);
+        case SNAP_PEG_QUEUE:
+            return record.status == ACTIVE && record.peg_type != PEG_NONE && live;
+        case SNAP_BUY_STOP:
+        case SNAP_SELL_STOP:
+            return record.status == PENDING && record.peg_type == PEG_NONE
+                && record.trigger_price == level_price && is_buy == (queue == SNAP_BUY_STOP);
+    }
+    return false;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+Order* BasicBook<MatchingPolicy, EventSink>::load_order(const SnapshotOrder& record) {
+    Order* order = order_pool.allocate(
+        record.order_id, record.agent_id, static_cast<OrderType>(record.side), record.price,
+        record.initial_volume, record.remaining_volume, static_cast<OrderStatus>(record.status),
+        record.display_volume, record.hidden != 0
+    );
+    order->set_reserve_volume(record.reserve_volume);
+    order->set_trigger_price(record.trigger_price);
+    order->set_expire_time(record.expire_time);
+    order->set_peg_type(static_cast<PegType>(record.peg_type));
+    return order;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+bool BasicBook<MatchingPolicy, EventSink>::load_snapshot(const char* path, std::uint64_t* journal_position) {
+    if (!id_to_order.empty() || !id_to_stop.empty()) {
+        return false;
+    }
+
+    std::vector<unsigned char> in;
+    if (!read_file(path, in) || in.size() < sizeof(SnapshotHeader)) {
+        return false;
+    }
+    SnapshotHeader header;
+    std::memcpy(&header, in.data(), sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION
+        || in.size() != sizeof(header) + header.level_count * sizeof(SnapshotLevel)
+                                      + header.order_count * sizeof(SnapshotOrder)) {
+        return false;
+    }
+
+    // The clock cannot run backwards: orders checked live at header.time could
+    // already be due on a book whose clock is past it
+    if (header.stp_mode > STP_DECREMENT || header.auction_mode > 1 || header.time < get_time()) {
+        return false;
+    }
+
+    // Validate every record before touching the book: framing, each list in
+    // strict price order (no duplicate levels), every order on the list it
+    // belongs to, no duplicate ids, and no crossed book outside an auction
+    Orders seen_ids;
+    seen_ids.reserve(header.order_count);
+    PRICE list_tail[SNAP_SELL_STOP + 1] = {};
+    PRICE best_bid_price = 0;
+    PRICE best_ask_price = 0;
+    size_t offset = sizeof(header);
+    for (std::uint64_t i = 0; i < header.level_count; ++i) {
+        if (offset + sizeof(SnapshotLevel) > in.size()) return false;
+        SnapshotLevel level;
+        std::memcpy(&level, in.data() + offset, sizeof(level));
+        if (level.queue > SNAP_SELL_STOP
+            || (level.order_count == 0 && level.queue != SNAP_PEG_QUEUE)
+            || level.order_count > (in.size() - offset - sizeof(level)) / sizeof(SnapshotOrder)) {
+            return false;
+        }
+        if (level.queue != SNAP_PEG_QUEUE) {
+            // Bids and sell stops descend, asks and buy stops ascend
+            PRICE tail = list_tail[level.queue];
+            bool ascending = (level.queue == SNAP_ASK_LEVEL || level.queue == SNAP_BUY_STOP);
+            if (level.price == 0
+                || (tail != 0 && (ascending ? level.price <= tail : level.price >= tail))) {
+                return false;
+            }
+            list_tail[level.queue] = level.price;
+            if (level.queue == SNAP_BID_LEVEL && best_bid_price == 0) best_bid_price = level.price;
+            if (level.queue == SNAP_ASK_LEVEL && best_ask_price == 0) best_ask_price = level.price;
+        }
+        offset += sizeof(level);
+
+        for (std::uint64_t j = 0; j < level.order_count; ++j) {
+            SnapshotOrder order_record;
+            std::memcpy(&order_record, in.data() + offset, sizeof(order_record));
+            offset += sizeof(order_record);
+            if (!valid_snapshot_order(order_record, level.queue, level.price, header.time)
+                || seen_ids.find(order_record.order_id) != seen_ids.end()) {
+                return false;
+            }
+            seen_ids[order_record.order_id] = nullptr;
+        }
+    }
+    if (offset != in.size()) return false;
+    if (!header.auction_mode && best_bid_price != 0 && best_ask_price != 0 && best_bid_price >= best_ask_price) {
+        return false;
+    }
+
+    id_to_order.reserve(header.order_count);
+    timer_wheel.advance(header.time, [](Order*) {});
+    last_trade_price = header.last_trade_price;
+    stp_mode = static_cast<StpMode>(header.stp_mode);
+    auction_mode = header.auction_mode != 0;
+
+    Level* buy_tail = nullptr;
+    Level* sell_tail = nullptr;
+    Level* buy_stop_tail = nullptr;
+    Level* sell_stop_tail = nullptr;
+    offset = sizeof(header);
+    for (std::uint64_t i = 0; i < header.level_count; ++i) {
+        SnapshotLevel record;
+        std::memcpy(&record, in.data() + offset, sizeof(record));
+        offset += sizeof(record);
+
+        Level* level = nullptr;
+        switch (record.queue) {
+            case SNAP_BID_LEVEL:
+                level = level_pool.allocate(record.price);
+                buy_side_limits[record.price] = level;
+                append_level(buy_list_head, buy_tail, level);
+                break;
+            case SNAP_ASK_LEVEL:
+                level = level_pool.allocate(record.price);
+                sell_side_limits[record.price] = level;
+                append_level(sell_list_head, sell_tail, level);
+                break;
+            case SNAP_BUY_STOP:
+                level = level_pool.allocate(record.price);
+                buy_stop_limits[record.price] = level;
+                append_level(buy_stop_head, buy_stop_tail, level);
+                break;
+            case SNAP_SELL_STOP:
+                level = level_pool.allocate(record.price);
+                sell_stop_limits[record.price] = level;
+                append_level(sell_stop_head, sell_stop_tail, level);
+                break;
+            case SNAP_PEG_QUEUE:
+                break; // queue chosen per order
+        }
+
+        for (std::uint64_t j = 0; j < record.order_count; ++j) {
+            SnapshotOrder order_record;
+            std::memcpy(&order_record, in.data() + offset, sizeof(order_record));
+            offset += sizeof(order_record);
+
+            Order* order = load_order(order_record);
+            if (record.queue == SNAP_BUY_STOP || record.queue == SNAP_SELL_STOP) {
+                level->push_back(order);
+                id_to_stop[order->get_order_id()] = order;
+                continue;
+            }
+            if (record.queue == SNAP_PEG_QUEUE) {
+                peg_queue(order).push_back(order);
+            } else {
+                level->push_back(order);
+            }
+            id_to_order[order->get_order_id()] = order;
+            if (LOB_UNLIKELY(order->get_expire_time() != 0)) {
+                timer_wheel.schedule(order);
+            }
+        }
+    }
+
+    if (journal_position) {
+        *journal_position = header.journal_position;
+    }
+    publish_top_of_book();
+    return true;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+OrderStatus BasicBook<MatchingPolicy, EventSink>::get_order_status(ID id) const {
+    auto it = id_to_order.find(id);
+    if (it != id_to_order.end()) {
+        return it->second->get_order_status();
+    }
+    if (LOB_UNLIKELY(!id_to_stop.empty()) && id_to_stop.find(id) != id_to_stop.end()) {
+        return PENDING;
+    }
+    return DELETED;
+}
+
+template<typename MatchingPolicy, typename EventSink>
+void BasicBook<MatchingPolicy, EventSink>::print() const {
+    std::cout << "==== BUY SIDE ====" << std::endl;
+    std::cout << "Best Buy: " << get_best_buy() << std::endl;
+    for (Level* l = buy_list_head; l; l = l->get_next_level()) {
+        l->print();
+    }
+    std::cout << "==== SELL SIDE ====" << std::endl;
+    std::cout << "Best Sell: " << get_best_sell() << std::endl;
+    for (Level* l = sell_list_head; l; l = l->get_next_level()) {
+        l->print();
+    }
+}
+
 #endif // LOB_BOOK_H
@@ -0,0 +1,87 @@
+#ifndef LOB_BOOK_EVENT_H
+#define LOB_BOOK_EVENT_H
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "EventSink.h"
+#include "SpscRing.h"
+
+enum BookEventType : std::uint8_t { BEV_REST, BEV_FILL, BEV_REPLENISH, BEV_CANCEL };
+
+/**
+ * BookEvent: order-level change of resting book state, enough to rebuild the
+ * book's levels and queues elsewhere (see ReplicaBook).
+ * - BEV_REST:      order joined a level (remaining = tip, reserve, display, hidden)
+ * - BEV_FILL:      volume traded; sent for both sides, the non-resting one is ignored
+ * - BEV_REPLENISH: iceberg tip refilled and moved to the tail
+ * - BEV_CANCEL:    volume removed without trading; remaining/reserve are what is left
+ */
+struct BookEvent {
+    std::uint64_t sequence;
+    ID order_id;
+    ID agent_id;
+    Volume volume;          // traded or cancelled volume
+    Volume remaining;
+    Volume reserve;
+    Volume display;
+    PRICE price;
+    BookEventType type;
+    std::uint8_t side;      // OrderType
+    std::uint8_t hidden;
+    std::uint8_t pegged;    // peg queues are not levels; replicas skip them
+};
+
+static_assert(std::is_trivially_copyable<BookEvent>::value, "BookEvent is copied bytewise");
+
+using BookEventRing = SpscRing<BookEvent>;
+
+/**
+ * BookEventSink: publishes sequenced BookEvents to one or more rings (one per
+ * replica); the matching thread spins if a replica falls a full ring behind.
+ */
+class BookEventSink : public NullEventSink {
+    private:
+        std::vector<BookEventRing*> rings;
+        std::uint64_t sequence;
+
+        void publish(BookEventType type, const Order& order, Volume volume) {
+            BookEvent event;
+            event.sequence = ++sequence;
+            event.order_id = order.get_order_id();
+            event.agent_id = order.get_agent_id();
+            event.volume = volume;
+            event.remaining = order.get_remaining_volume();
+            event.reserve = order.get_reserve_volume();
+            event.display = order.get_display_volume();
+            event.price = order.get_order_price();
+            event.type = type;
+            event.side = static_cast<std::uint8_t>(order.get_order_type());
+            event.hidden = order.is_hidden();
+            event.pegged = (order.get_peg_type() != PEG_NONE);
+            for (BookEventRing* ring : rings) {
+                ring->push(event);
+            }
+        }
+
+    public:
+        BookEventSink() : sequence(0) {}
+        explicit BookEventSink(BookEventRing& ring) : rings{&ring}, sequence(0) {}
+
+        /** Adds a replica feed; only before the book starts producing events */
+        void add_ring(BookEventRing& ring) { rings.push_back(&ring); }
+
+        void on_rest(const Order& order) { publish(BEV_REST, order, order.get_remaining_volume()); }
+        void on_trade(const Order& incoming, const Order& resting, PRICE /*price*/, Volume volume) {
+            publish(BEV_FILL, resting, volume);
+            publish(BEV_FILL, incoming, volume);
+        }
+        void on_replenish(const Order& order) { publish(BEV_REPLENISH, order, 0); }
+        void on_cancel(const Order& order, Volume cancelled_volume, CancelReason /*reason*/) {
+            publish(BEV_CANCEL, order, cancelled_volume);
+        }
+
+        std::uint64_t get_sequence() const { return sequence; }
+};
+
+#endif // LOB_BOOK_EVENT_H
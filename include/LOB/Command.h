@@ -0,0 +1,41 @@
+#ifndef LOB_COMMAND_H
+#define LOB_COMMAND_H
+
+#include <cstdint>
+#include <type_traits>
+#include "Types.h"
+#include "SpscRing.h"
+#include "MpscQueue.h"
+
+enum CommandType : std::uint8_t { CMD_NEW, CMD_CANCEL, CMD_AMEND };
+
+/**
+ * Command: fixed-size gateway-to-engine message.
+ * - CMD_NEW:    limit order (order_id, agent_id, side, price, volume)
+ * - CMD_CANCEL: order_id only
+ * - CMD_AMEND:  order_id, new price and new volume (see Book::amend_order)
+ * timestamp is set by the sender (e.g. enqueue time in ns) and is not
+ * interpreted by the engine. symbol_id selects the book in a multi-symbol
+ * engine and is ignored by a single-book EngineRunner. sequence is stamped
+ * by MpscQueue at enqueue and gives the total input order across gateways.
+ */
+struct Command {
+    ID order_id;
+    ID agent_id;
+    Volume volume;
+    Timestamp timestamp;
+    std::uint64_t sequence;
+    PRICE price;
+    std::uint32_t symbol_id;
+    CommandType type;
+    std::uint8_t side;      // OrderType
+    std::uint8_t reserved[6];
+};
+
+static_assert(sizeof(Command) == 56, "Command layout is part of the wire format");
+static_assert(std::is_trivially_copyable<Command>::value, "Command is copied bytewise");
+
+using CommandRing = SpscRing<Command>;
+using CommandQueue = MpscQueue<Command>;
+
+#endif // LOB_COMMAND_H
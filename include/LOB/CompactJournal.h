@@ -0,0 +1,307 @@
+#ifndef LOB_COMPACT_JOURNAL_H
+#define LOB_COMPACT_JOURNAL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "Command.h"
+#include "Macros.h"
+
+/**
+ * Compact journal: Commands delta-encoded into independently decodable blocks.
+ *
+ * File layout (host byte order):
+ *   CompactFileHeader
+ *   blocks:  CompactBlockHeader + payload
+ *   index:   CompactIndexEntry per block
+ *   CompactFooter
+ *
+ * Each record starts with a tag byte (type, side, which optional fields
+ * follow), then zigzag varint deltas of order_id, agent_id and price against
+ * the previous record of the same block, and the volume as a plain varint.
+ * Agent, price and volume are omitted where the command type does not use
+ * them; the symbol and timestamp only appear when they change. Delta state
+ * resets at every block boundary, so any block decodes on its own and the
+ * index gives O(log blocks) seeks to a record number. Sequence numbers are
+ * not stored (they are re-stamped on ingress).
+ *
+ * A file whose footer is missing (writer crashed) is still readable by
+ * walking the block headers.
+ */
+struct CompactFileHeader {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t block_bytes;
+};
+
+struct CompactBlockHeader {
+    std::uint32_t payload_bytes;
+    std::uint32_t record_count;
+};
+
+struct CompactIndexEntry {
+    std::uint64_t offset;           /**< File offset of the CompactBlockHeader */
+    std::uint64_t first_record;     /**< Record number of the block's first record */
+};
+
+struct CompactFooter {
+    std::uint64_t index_offset;
+    std::uint64_t block_count;
+    std::uint64_t record_count;
+    std::uint64_t magic;
+};
+
+constexpr std::uint64_t COMPACT_JOURNAL_MAGIC = 0x314E524A43424F4CULL; // "LOBCJRN1"
+constexpr std::uint32_t COMPACT_JOURNAL_VERSION = 1;
+
+/** Delta state shared by the encoder and decoder; reset per block */
+struct CompactDeltaState {
+    ID order_id = 0;
+    ID agent_id = 0;
+    PRICE price = 0;
+    std::uint32_t symbol_id = 0;
+    Timestamp timestamp = 0;
+};
+
+/** Worst-case encoded size of one record */
+constexpr size_t COMPACT_MAX_RECORD_BYTES = 64;
+
+namespace compact_detail {
+
+constexpr std::uint8_t TAG_TYPE_MASK = 0x03;
+constexpr std::uint8_t TAG_SIDE = 0x04;
+constexpr std::uint8_t TAG_SYMBOL = 0x08;
+constexpr std::uint8_t TAG_TIMESTAMP = 0x10;
+
+inline std::uint64_t zigzag(std::int64_t v) {
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+inline std::int64_t unzigzag(std::uint64_t v) {
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+inline unsigned char* put_varint(unsigned char* out, std::uint64_t v) {
+    while (v >= 0x80) {
+        *out++ = static_cast<unsigned char>(v | 0x80);
+        v >>= 7;
+    }
+    *out++ = static_cast<unsigned char>(v);
+    return out;
+}
+
+// Returns nullptr on truncation or a varint longer than 10 bytes
+inline const unsigned char* get_varint(const unsigned char* in, const unsigned char* end, std::uint64_t& v) {
+    if (LOB_LIKELY(in != end && *in < 0x80)) {
+        v = *in;
+        return in + 1;
+    }
+    std::uint64_t result = 0;
+    for (unsigned shift = 0; shift < 70 && in != end; shift += 7) {
+        std::uint64_t byte = *in++;
+        result |= (byte & 0x7f) << shift;
+        if (byte < 0x80) {
+            v = result;
+            return in;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace compact_detail
+
+/**
+ * @brief Encodes one command at `out` (at least COMPACT_MAX_RECORD_BYTES free)
+ * @return bytes written
+ */
+inline size_t encode_compact(const Command& command, CompactDeltaState& state, unsigned char* out) {
+    using namespace compact_detail;
+    unsigned char* p = out + 1;
+    std::uint8_t tag = static_cast<std::uint8_t>(command.type) & TAG_TYPE_MASK;
+    if (command.side == SELL) tag |= TAG_SIDE;
+
+    p = put_varint(p, zigzag(static_cast<std::int64_t>(command.order_id - state.order_id)));
+    state.order_id = command.order_id;
+    if (command.type == CMD_NEW) {
+        p = put_varint(p, zigzag(static_cast<std::int64_t>(command.agent_id - state.agent_id)));
+        state.agent_id = command.agent_id;
+    }
+    if (command.type != CMD_CANCEL) {
+        p = put_varint(p, zigzag(static_cast<std::int64_t>(command.price) - state.price));
+        state.price = command.price;
+        p = put_varint(p, command.volume);
+    }
+    if (LOB_UNLIKELY(command.symbol_id != state.symbol_id)) {
+        tag |= TAG_SYMBOL;
+        p = put_varint(p, zigzag(static_cast<std::int64_t>(command.symbol_id) - state.symbol_id));
+        state.symbol_id = command.symbol_id;
+    }
+    if (command.timestamp != state.timestamp) {
+        tag |= TAG_TIMESTAMP;
+        p = put_varint(p, zigzag(static_cast<std::int64_t>(command.timestamp - state.timestamp)));
+        state.timestamp = command.timestamp;
+    }
+    *out = tag;
+    return static_cast<size_t>(p - out);
+}
+
+/**
+ * @brief Decodes one record from [in, end) into `command`
+ * Fields the command type does not use (agent of an amend, price and volume
+ * of a cancel) decode as 0; sequence is left untouched.
+ * @return bytes consumed, or 0 if the record is truncated or malformed
+ */
+inline size_t decode_compact(const unsigned char* in, const unsigned char* end,
+                             CompactDeltaState& state, Command& command) {
+    using namespace compact_detail;
+    if (LOB_UNLIKELY(in == end)) return 0;
+    const unsigned char* p = in;
+    std::uint8_t tag = *p++;
+    std::uint64_t v;
+
+    if (LOB_UNLIKELY((tag & TAG_TYPE_MASK) > CMD_AMEND)) return 0;
+    command.type = static_cast<CommandType>(tag & TAG_TYPE_MASK);
+    command.side = (tag & TAG_SIDE) ? SELL : BUY;
+    if (!(p = get_varint(p, end, v))) return 0;
+    state.order_id += static_cast<ID>(unzigzag(v));
+    command.order_id = state.order_id;
+
+    command.agent_id = 0;
+    if (command.type == CMD_NEW) {
+        if (!(p = get_varint(p, end, v))) return 0;
+        state.agent_id += static_cast<ID>(unzigzag(v));
+        command.agent_id = state.agent_id;
+    }
+    command.price = 0;
+    command.volume = 0;
+    if (command.type != CMD_CANCEL) {
+        if (!(p = get_varint(p, end, v))) return 0;
+        state.price = static_cast<PRICE>(static_cast<std::int64_t>(state.price) + unzigzag(v));
+        command.price = state.price;
+        if (!(p = get_varint(p, end, v))) return 0;
+        command.volume = v;
+    }
+    if (LOB_UNLIKELY(tag & TAG_SYMBOL)) {
+        if (!(p = get_varint(p, end, v))) return 0;
+        state.symbol_id = static_cast<std::uint32_t>(static_cast<std::int64_t>(state.symbol_id) + unzigzag(v));
+    }
+    command.symbol_id = state.symbol_id;
+    if (tag & TAG_TIMESTAMP) {
+        if (!(p = get_varint(p, end, v))) return 0;
+        state.timestamp += static_cast<Timestamp>(unzigzag(v));
+    }
+    command.timestamp = state.timestamp;
+    return static_cast<size_t>(p - in);
+}
+
+/**
+ * CompactJournalWriter: buffers one block in memory and writes it when full;
+ * close() (or the destructor) writes the last block, the index and the footer.
+ */
+class CompactJournalWriter {
+    private:
+        std::FILE* file;
+        std::vector<unsigned char> block;
+        size_t block_bytes;
+        size_t block_used;
+        std::uint32_t block_records;
+        CompactDeltaState state;
+        std::uint64_t offset;
+        std::uint64_t records;
+        std::vector<CompactIndexEntry> index;
+
+        bool write_block();
+
+    public:
+        explicit CompactJournalWriter(const char* path, size_t block_bytes = 1 << 16);
+        ~CompactJournalWriter();
+
+        CompactJournalWriter(const CompactJournalWriter&) = delete;
+        CompactJournalWriter& operator=(const CompactJournalWriter&) = delete;
+
+        bool is_open() const { return file != nullptr; }
+
+        bool append(const Command& command) {
+            if (LOB_UNLIKELY(block_used + COMPACT_MAX_RECORD_BYTES > block_bytes)) {
+                if (!write_block()) return false;
+            }
+            block_used += encode_compact(command, state, block.data() + sizeof(CompactBlockHeader) + block_used);
+            ++block_records;
+            ++records;
+            return true;
+        }
+
+        /** @brief Writes the pending block, the index and the footer */
+        bool close();
+
+        std::uint64_t get_record_count() const { return records; }
+        /** Bytes written to the file so far (blocks only until close()) */
+        std::uint64_t get_file_bytes() const { return offset; }
+};
+
+/**
+ * CompactJournalReader: loads a compact journal and decodes it on demand.
+ */
+class CompactJournalReader {
+    private:
+        std::vector<unsigned char> bytes;
+        std::vector<CompactIndexEntry> index;
+        std::uint64_t records;
+        bool valid;
+
+        bool load_index();
+        bool scan_blocks();
+
+    public:
+        explicit CompactJournalReader(const char* path);
+
+        /** False if the file is missing or not a compact journal */
+        bool is_open() const { return valid; }
+        std::uint64_t get_record_count() const { return records; }
+        size_t get_block_count() const { return index.size(); }
+        size_t get_file_bytes() const { return bytes.size(); }
+
+        /**
+         * @brief Calls fn(const Command&) for records [from, end), in order
+         * Seeks through the block index, so a late `from` costs one block decode.
+         * @return number of records delivered
+         */
+        template<typename Fn>
+        size_t replay(Fn&& fn, std::uint64_t from = 0) const {
+            if (!valid || from >= records) return 0;
+
+            // Last block whose first record is <= from
+            size_t lo = 0, hi = index.size();
+            while (hi - lo > 1) {
+                size_t mid = (lo + hi) / 2;
+                if (index[mid].first_record <= from) lo = mid;
+                else hi = mid;
+            }
+
+            size_t delivered = 0;
+            for (size_t b = lo; b < index.size(); ++b) {
+                const unsigned char* p = bytes.data() + index[b].offset;
+                CompactBlockHeader header;
+                std::memcpy(&header, p, sizeof(header));
+                p += sizeof(header);
+                const unsigned char* end = p + header.payload_bytes;
+
+                CompactDeltaState state;
+                Command command{};
+                std::uint64_t number = index[b].first_record;
+                for (std::uint32_t i = 0; i < header.record_count; ++i, ++number) {
+                    size_t used = decode_compact(p, end, state, command);
+                    if (LOB_UNLIKELY(used == 0)) return delivered;
+                    p += used;
+                    if (number >= from) {
+                        fn(static_cast<const Command&>(command));
+                        ++delivered;
+                    }
+                }
+            }
+            return delivered;
+        }
+};
+
+#endif // LOB_COMPACT_JOURNAL_H
@@ -0,0 +1,189 @@
+#ifndef LOB_ENGINE_RUNNER_H
+#define LOB_ENGINE_RUNNER_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "Book.h"
+#include "Command.h"
+#include "ExecutionReport.h"
+
+class Journal;
+class UringJournal;
+class StandbyPublisher;
+
+/**
+ * Idle policy of a thread polling a queue.
+ * - WAIT_BUSY_SPIN: spin with a pause hint only (lowest latency, owns the core)
+ * - WAIT_BACKOFF:   spin, then yield, then sleep briefly while idle
+ */
+enum WaitStrategy { WAIT_BUSY_SPIN, WAIT_BACKOFF };
+
+/**
+ * @brief Waits one idle round according to `strategy`
+ * @param idle_rounds consecutive empty polls so far (escalates the backoff)
+ */
+void idle_wait(WaitStrategy strategy, unsigned idle_rounds);
+
+/**
+ * @brief Pins the calling thread to one CPU (no-op off Linux)
+ * @return true on success
+ */
+bool pin_current_thread(int cpu);
+
+using RunnerBook = BasicBook<FifoMatching, ExecutionReportSink>;
+extern template class BasicBook<FifoMatching, ExecutionReportSink>;
+
+/**
+ * @brief Applies one gateway command to a book (new / cancel / amend)
+ * Any BasicBook instantiation; the engine threads use RunnerBook.
+ */
+template<typename BookType>
+void apply_command(BookType& book, const Command& command) {
+    switch (command.type) {
+        case CMD_NEW:
+            book.place_order(command.order_id, command.agent_id,
+                             static_cast<OrderType>(command.side), command.price, command.volume);
+            break;
+        case CMD_CANCEL:
+            book.delete_order(command.order_id);
+            break;
+        case CMD_AMEND:
+            book.amend_order(command.order_id, command.price, command.volume);
+            break;
+    }
+}
+
+/**
+ * EngineRunner: owns a Book on a dedicated (optionally pinned) thread.
+ *
+ * Ingress is either a CommandRing written by one gateway thread or a
+ * CommandQueue shared by several gateway threads (drained in the order the
+ * queue stamped). The runner is the only producer of the egress
+ * ExecutionRing, which receives one ExecutionReport per order state change.
+ * Commands are applied in ingress order, in batches. With a StandbyPublisher
+ * attached, each command is first published to the hot-standby follower, and
+ * the heartbeat is stamped once per batch and idle round. With a Journal (or
+ * UringJournal) attached, each command is then appended to it just before it
+ * is applied; when a Journal fills up, or every UringJournal segment is
+ * still in flight, the runner stops before the command that does not fit
+ * (is_journal_full()). Once the follower has promoted itself the runner is fenced: it
+ * applies nothing more and stops on its own (is_fenced()).
+ */
+class EngineRunner {
+    private:
+        static constexpr size_t BATCH_SIZE = 64;
+
+        CommandRing* spsc_ingress;   // exactly one of the two is set
+        CommandQueue* mpsc_ingress;
+        RunnerBook book;
+        int cpu;
+        WaitStrategy wait_strategy;
+        Journal* journal;
+        UringJournal* uring_journal;
+        StandbyPublisher* standby;
+
+        alignas(LOB_CACHE_LINE) std::atomic<bool> running;
+        std::atomic<bool> fenced;
+        std::atomic<bool> journal_full;
+        std::atomic<std::uint64_t> processed;
+        std::thread worker;
+
+        void run();
+        void journal_command(const Command& command);
+        void persist_idle();
+        template<typename Fn>
+        size_t poll(Fn&& fn) {
+            return spsc_ingress ? spsc_ingress->consume(fn, BATCH_SIZE)
+                                : mpsc_ingress->consume(fn, BATCH_SIZE);
+        }
+
+    public:
+        /**
+         * @param cpu core to pin the matching thread to (-1 = not pinned)
+         * @param initial_capacity order pool size of the book
+         */
+        EngineRunner(
+            CommandRing& ingress,
+            ExecutionRing& egress,
+            int cpu = -1,
+            WaitStrategy wait_strategy = WAIT_BACKOFF,
+            size_t initial_capacity = 65536
+        );
+        EngineRunner(
+            CommandQueue& ingress,
+            ExecutionRing& egress,
+            int cpu = -1,
+            WaitStrategy wait_strategy = WAIT_BACKOFF,
+            size_t initial_capacity = 65536
+        );
+        ~EngineRunner();
+
+        EngineRunner(const EngineRunner&) = delete;
+        EngineRunner& operator=(const EngineRunner&) = delete;
+
+        /**
+         * @brief Journals every command applied from now on (a null Journal* detaches)
+         * Only while stopped; the journal's flusher is started and stopped by
+         * its owner. Once the journal is full the runner stops, leaving the
+         * command that did not fit and everything after it in the ingress;
+         * once is_running() is false, attach a fresh journal and start()
+         * again to carry on (no stop() needed).
+         * @return false (nothing attached) if a UringJournal is attached:
+         *         commands go to exactly one journal
+         */
+        bool attach_journal(Journal* journal) {
+            if (journal && uring_journal) return false;
+            this->journal = journal;
+            journal_full.store(false, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * @brief Journals through io_uring instead: the matching thread only
+         * copies records and posts full segments; while idle it posts the
+         * partial segment and an fdatasync. It never waits for the disk: if
+         * every segment is still in flight the runner stops like on a full
+         * Journal, and the journal is drained as the thread exits, so
+         * re-attaching it and calling start() carries on.
+         * @return false (nothing attached) if a Journal is attached or the
+         *         UringJournal is not open
+         */
+        bool attach_journal(UringJournal* journal);
+
+        /**
+         * @brief Replicates every command applied from now on to a hot-standby
+         * follower (null detaches; only while stopped). The matching thread
+         * spins while the follower is a full ring behind, until the publisher
+         * drops it (the runner then carries on unreplicated). If the follower
+         * promotes, the runner stops without applying the command that sees
+         * the fence: it and every later command stay in the ingress. Whenever
+         * the matching thread exits otherwise (stop(), full journal) it pauses
+         * the publisher so the follower does not promote, and start() resumes it.
+         */
+        void attach_standby(StandbyPublisher* standby) { this->standby = standby; }
+
+        /**
+         * @brief Starts the matching thread; no-op once fenced
+         * Joins the previous thread first if the runner stopped on its own.
+         */
+        void start();
+
+        /**
+         * @brief Applies every command already in the ingress ring (unless
+         * fenced or the journal is full), then joins the matching thread
+         */
+        void stop();
+
+        bool is_running() const { return running.load(std::memory_order_acquire); }
+        /** True once the standby follower has promoted: this runner has stopped for good */
+        bool is_fenced() const { return fenced.load(std::memory_order_acquire); }
+        /** True once the attached journal could not take the next command: the runner stopped before it */
+        bool is_journal_full() const { return journal_full.load(std::memory_order_acquire); }
+        std::uint64_t get_processed() const { return processed.load(std::memory_order_acquire); }
+
+        /** The book; only safe to use while the runner is stopped */
+        RunnerBook& get_book() { return book; }
+};
+
+#endif // LOB_ENGINE_RUNNER_H
@@ -0,0 +1,76 @@
+#ifndef LOB_EVENT_HASH_H
+#define LOB_EVENT_HASH_H
+
+#include <cstdint>
+#include "EventSink.h"
+#include "StateHash.h"
+
+/**
+ * EventHashSink: folds every event the book emits (accepts, rejects, trades,
+ * rests, replenishes, cancels, level updates) into one rolling 64-bit hash.
+ *
+ * Two runs over the same input produce the same hash only if the engine made
+ * exactly the same decisions in the same order, so comparing hashes before
+ * and after an engine change qualifies it as bit-identical.
+ */
+class EventHashSink : public NullEventSink {
+    private:
+        enum Tag : std::uint64_t { ACCEPT = 1, REJECT, TRADE, REST, REPLENISH, CANCEL, LEVEL };
+
+        std::uint64_t hash = STATE_HASH_SEED;
+        std::uint64_t events = 0;
+
+        void mix(std::uint64_t value) { hash = hash_mix(hash, value); }
+
+    public:
+        void on_accept(const Order& order) {
+            mix(ACCEPT);
+            mix(order.get_order_id());
+            ++events;
+        }
+        void on_reject(ID order_id, ID /*agent_id*/, OrderType /*order_type*/, RejectReason reason) {
+            mix(REJECT);
+            mix(order_id);
+            mix(reason);
+            ++events;
+        }
+        void on_trade(const Order& incoming, const Order& resting, PRICE price, Volume volume) {
+            mix(TRADE);
+            mix(incoming.get_order_id());
+            mix(resting.get_order_id());
+            mix(price);
+            mix(volume);
+            ++events;
+        }
+        void on_rest(const Order& order) {
+            mix(REST);
+            mix(order.get_order_id());
+            mix(order.get_order_price());
+            mix(order.get_remaining_volume());
+            ++events;
+        }
+        void on_replenish(const Order& order) {
+            mix(REPLENISH);
+            mix(order.get_order_id());
+            ++events;
+        }
+        void on_cancel(const Order& order, Volume cancelled_volume, CancelReason reason) {
+            mix(CANCEL);
+            mix(order.get_order_id());
+            mix(cancelled_volume);
+            mix(reason);
+            ++events;
+        }
+        void on_level_update(OrderType side, const Level& level) {
+            mix(LEVEL);
+            mix(side);
+            mix(level.get_price());
+            mix(level.get_displayed_volume());
+            ++events;
+        }
+
+        std::uint64_t get_hash() const { return hash; }
+        std::uint64_t get_event_count() const { return events; }
+};
+
+#endif // LOB_EVENT_HASH_H
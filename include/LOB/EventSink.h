@@ -0,0 +1,72 @@
+#ifndef LOB_EVENT_SINK_H
+#define LOB_EVENT_SINK_H
+
+#include "Order.h"
+#include "Level.h"
+#include "Trade.h"
+
+/**
+ * Event sinks: compile-time receivers of BasicBook output (template parameter).
+ *
+ * The book calls every hook directly at the point the event happens, so a
+ * sink's hooks inline into the matcher. Custom sinks derive from
+ * NullEventSink and hide only the hooks they need; the rest stay empty.
+ *
+ * Hooks:
+ * - begin():       start of a call that reports a result (place_*, uncross)
+ * - on_accept():   a new order passed validation (before it matches or rests)
+ * - on_reject():   a new order failed validation and was never allocated
+ * - on_trade():    a fill; both orders already show their post-fill volume
+ * - on_rest():     an order was added to a level or peg queue
+ * - on_replenish(): an iceberg tip was refilled and re-queued at the tail
+ * - on_cancel():   volume left the book without trading; the order is gone
+ *                  once both its remaining and reserve volume are zero
+ * - on_level_update(): a book level changed (once per level per match step,
+ *                  rest or removal); an empty level is being deleted.
+ *                  Resting, amending or removing a hidden order changes
+ *                  nothing displayed and is not reported. Peg queues are not
+ *                  book levels and are not reported.
+ * - result():      return value of place_* and uncross
+ */
+struct NullEventSink {
+    void begin() {}
+    void on_accept(const Order& /*order*/) {}
+    void on_reject(ID /*order_id*/, ID /*agent_id*/, OrderType /*order_type*/,
+                   RejectReason /*reason*/) {}
+    void on_trade(const Order& /*incoming*/, const Order& /*resting*/,
+                  PRICE /*price*/, Volume /*volume*/) {}
+    void on_rest(const Order& /*order*/) {}
+    void on_replenish(const Order& /*order*/) {}
+    void on_cancel(const Order& /*order*/, Volume /*cancelled_volume*/,
+                   CancelReason /*reason*/) {}
+    void on_level_update(OrderType /*side*/, const Level& /*level*/) {}
+    void result() const {}
+};
+
+/**
+ * TradeBufferSink: collects the trades of one call into a reusable vector
+ * and returns it from place_* (the default Book behaviour).
+ */
+class TradeBufferSink : public NullEventSink {
+    private:
+        static constexpr size_t TRADE_BUFFER_SIZE = 16;
+        Trades trade_buffer;
+
+    public:
+        TradeBufferSink() { trade_buffer.reserve(TRADE_BUFFER_SIZE); }
+
+        void begin() { trade_buffer.clear(); }
+
+        void on_trade(const Order& incoming, const Order& resting, PRICE price, Volume volume) {
+            trade_buffer.emplace_back(
+                incoming.get_order_id(),
+                resting.get_order_id(),
+                price,
+                volume
+            );
+        }
+
+        const Trades& result() const { return trade_buffer; }
+};
+
+#endif // LOB_EVENT_SINK_H
@@ -0,0 +1,120 @@
+#ifndef LOB_EXECUTION_REPORT_H
+#define LOB_EXECUTION_REPORT_H
+
+#include <cstdint>
+#include <type_traits>
+#include "Types.h"
+#include "EventSink.h"
+#include "SpscRing.h"
+
+enum ExecType : std::uint8_t {
+    EXEC_ACCEPTED,
+    EXEC_PARTIAL_FILL,
+    EXEC_FILL,
+    EXEC_CANCELLED,
+    EXEC_REJECTED
+};
+
+/**
+ * ExecutionReport: fixed-size (one cache line) binary record of an order
+ * state change. Records are trivially copyable so they can be written to
+ * rings, files or sockets as raw bytes.
+ *
+ * - price:         fill price for fills, order price otherwise
+ * - last_volume:   filled or cancelled volume (0 for accepted / rejected)
+ * - leaves_volume: volume still working, including an iceberg's reserve
+ * - reason:        CancelReason for cancels, RejectReason for rejects
+ */
+struct alignas(LOB_CACHE_LINE) ExecutionReport {
+    std::uint64_t sequence;
+    ID order_id;
+    ID agent_id;
+    ID contra_order_id;     // resting / incoming counterparty of a fill
+    Volume last_volume;
+    Volume leaves_volume;
+    PRICE price;
+    std::uint32_t symbol_id;
+    ExecType exec_type;
+    std::uint8_t side;      // OrderType
+    std::uint8_t reason;
+};
+
+static_assert(sizeof(ExecutionReport) == LOB_CACHE_LINE, "ExecutionReport must stay one cache line");
+static_assert(std::is_trivially_copyable<ExecutionReport>::value, "ExecutionReport is copied bytewise");
+
+using ExecutionRing = SpscRing<ExecutionReport>;
+
+/**
+ * ExecutionReportSink: turns book events into sequenced ExecutionReports and
+ * pushes them into a caller-owned ring. The book thread is the ring's only
+ * producer; when the ring is full it spins until a consumer catches up, so
+ * no report is ever dropped or allocated.
+ */
+class ExecutionReportSink : public NullEventSink {
+    private:
+        ExecutionRing* ring;
+        std::uint64_t sequence;
+        std::uint32_t symbol_id;
+
+        static Volume leaves(const Order& order) {
+            return order.get_remaining_volume() + order.get_reserve_volume();
+        }
+
+        void publish(ExecType type, const Order& order, ID contra, PRICE price,
+                     Volume last, std::uint8_t reason) {
+            ExecutionReport report;
+            report.sequence = ++sequence;
+            report.order_id = order.get_order_id();
+            report.agent_id = order.get_agent_id();
+            report.contra_order_id = contra;
+            report.last_volume = last;
+            report.leaves_volume = leaves(order);
+            report.price = price;
+            report.symbol_id = symbol_id;
+            report.exec_type = type;
+            report.side = static_cast<std::uint8_t>(order.get_order_type());
+            report.reason = reason;
+            ring->push(report);
+        }
+
+        void publish_fill(const Order& order, ID contra, PRICE price, Volume volume) {
+            publish(leaves(order) == 0 ? EXEC_FILL : EXEC_PARTIAL_FILL, order, contra, price, volume, 0);
+        }
+
+    public:
+        explicit ExecutionReportSink(ExecutionRing& ring, std::uint32_t symbol_id = 0)
+            : ring(&ring), sequence(0), symbol_id(symbol_id) {}
+
+        /** Redirects later reports; only while no other thread uses the sink */
+        void set_ring(ExecutionRing& new_ring) { ring = &new_ring; }
+
+        void on_accept(const Order& order) {
+            publish(EXEC_ACCEPTED, order, 0, order.get_order_price(), 0, 0);
+        }
+
+        void on_reject(ID order_id, ID agent_id, OrderType order_type, RejectReason reason) {
+            ExecutionReport report = {};
+            report.sequence = ++sequence;
+            report.order_id = order_id;
+            report.agent_id = agent_id;
+            report.symbol_id = symbol_id;
+            report.exec_type = EXEC_REJECTED;
+            report.side = static_cast<std::uint8_t>(order_type);
+            report.reason = static_cast<std::uint8_t>(reason);
+            ring->push(report);
+        }
+
+        void on_trade(const Order& incoming, const Order& resting, PRICE price, Volume volume) {
+            publish_fill(incoming, resting.get_order_id(), price, volume);
+            publish_fill(resting, incoming.get_order_id(), price, volume);
+        }
+
+        void on_cancel(const Order& order, Volume cancelled_volume, CancelReason reason) {
+            publish(EXEC_CANCELLED, order, 0, order.get_order_price(), cancelled_volume,
+                    static_cast<std::uint8_t>(reason));
+        }
+
+        std::uint64_t get_sequence() const { return sequence; }
+};
+
+#endif // LOB_EXECUTION_REPORT_H
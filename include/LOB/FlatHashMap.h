@@ -70,8 +70,10 @@ private:
         return s;
     }
 
+    // Doubles, unless tombstones make up most of the load: then rehashes in
+    // place, so erase-heavy churn at a steady size does not keep growing
     void grow_and_rehash() {
-        size_t new_cap = capacity_ * 2;
+        size_t new_cap = (size_ * 2 < used_) ? capacity_ : capacity_ * 2;
         Slot* new_slots = allocate_slots(new_cap);
         size_t mask = new_cap - 1;
 
@@ -0,0 +1,274 @@
+#ifndef LOB_ITCH_H
+#define LOB_ITCH_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Book.h"
+#include "Macros.h"
+
+/**
+ * NASDAQ TotalView-ITCH 5.0 capture files.
+ *
+ * A capture (as distributed, after gunzip) is a sequence of messages, each
+ * prefixed with its length as a big-endian uint16. Every message starts
+ * with a type byte, the stock locate code (uint16), a tracking number
+ * (uint16) and a 6-byte timestamp (ns since midnight); all integers are
+ * big-endian and prices carry four implied decimals (so they fit PRICE
+ * unscaled).
+ *
+ * parse_itch() walks the mapped bytes in place: fields are decoded straight
+ * from the mapping into handler arguments and no message is ever copied.
+ */
+
+/** Message types mapped onto book operations (others are only counted) */
+inline constexpr char ITCH_STOCK_DIRECTORY = 'R';
+inline constexpr char ITCH_ADD_ORDER = 'A';
+inline constexpr char ITCH_ADD_ORDER_MPID = 'F';
+inline constexpr char ITCH_ORDER_EXECUTED = 'E';
+inline constexpr char ITCH_ORDER_EXECUTED_PRICE = 'C';
+inline constexpr char ITCH_ORDER_CANCEL = 'X';
+inline constexpr char ITCH_ORDER_DELETE = 'D';
+inline constexpr char ITCH_ORDER_REPLACE = 'U';
+
+/** Stock locate codes are uint16: one book slot per possible code */
+inline constexpr size_t ITCH_MAX_LOCATES = 65536;
+
+inline std::uint16_t itch_load16(const unsigned char* p) {
+    std::uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return __builtin_bswap16(v);
+}
+
+inline std::uint32_t itch_load32(const unsigned char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return __builtin_bswap32(v);
+}
+
+inline std::uint64_t itch_load48(const unsigned char* p) {
+    return (static_cast<std::uint64_t>(itch_load16(p)) << 32) | itch_load32(p + 2);
+}
+
+inline std::uint64_t itch_load64(const unsigned char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return __builtin_bswap64(v);
+}
+
+/** Add Order ('A', or 'F' with an MPID attribution that is ignored) */
+struct ItchAddOrder {
+    std::uint16_t locate;
+    Timestamp timestamp;
+    ID order_ref;
+    OrderType side;
+    Volume shares;
+    PRICE price;
+    const char* stock;   // 8 space-padded chars inside the mapping
+};
+
+/**
+ * Handlers: compile-time receivers of parse_itch() (same pattern as the
+ * book's event sinks). Derive from NullItchHandler and hide the hooks you
+ * need; executions with and without price ('E' / 'C') both arrive as
+ * on_execute().
+ */
+struct NullItchHandler {
+    void on_stock_directory(std::uint16_t /*locate*/, const char* /*stock*/) {}
+    void on_add(const ItchAddOrder& /*add*/) {}
+    void on_execute(std::uint16_t /*locate*/, ID /*order_ref*/, Volume /*shares*/) {}
+    void on_cancel(std::uint16_t /*locate*/, ID /*order_ref*/, Volume /*shares*/) {}
+    void on_delete(std::uint16_t /*locate*/, ID /*order_ref*/) {}
+    void on_replace(std::uint16_t /*locate*/, ID /*old_ref*/, ID /*new_ref*/,
+                    Volume /*shares*/, PRICE /*price*/) {}
+};
+
+struct ItchParseStats {
+    std::uint64_t messages = 0;
+    std::uint64_t bytes = 0;             // consumed, including length prefixes
+    std::uint64_t first_timestamp = 0;
+    std::uint64_t last_timestamp = 0;
+    std::uint64_t malformed = 0;         // known type, too short: skipped
+    bool truncated = false;              // the file ends inside a message
+    std::array<std::uint64_t, 256> by_type{};
+};
+
+/**
+ * @brief Decodes every complete message in [data, data + size) and hands the
+ * book-relevant ones to handler
+ */
+template<typename Handler>
+ItchParseStats parse_itch(const unsigned char* data, size_t size, Handler& handler) {
+    ItchParseStats stats;
+    size_t pos = 0;
+    while (pos + 2 <= size) {
+        size_t length = itch_load16(data + pos);
+        if (LOB_UNLIKELY(pos + 2 + length > size)) {
+            stats.truncated = true;
+            break;
+        }
+        const unsigned char* m = data + pos + 2;
+        pos += 2 + length;
+        if (LOB_UNLIKELY(length < 11)) {
+            ++stats.malformed;
+            continue;
+        }
+
+        unsigned char type = m[0];
+        std::uint16_t locate = itch_load16(m + 1);
+        std::uint64_t timestamp = itch_load48(m + 5);
+        if (LOB_UNLIKELY(stats.messages == 0)) stats.first_timestamp = timestamp;
+        stats.last_timestamp = timestamp;
+        ++stats.messages;
+        ++stats.by_type[type];
+
+        switch (type) {
+            case ITCH_ADD_ORDER:
+            case ITCH_ADD_ORDER_MPID:
+                if (LOB_UNLIKELY(length < 36)) break;
+                handler.on_add(ItchAddOrder{
+                    locate, timestamp, itch_load64(m + 11), m[19] == 'B' ? BUY : SELL,
+                    itch_load32(m + 20), itch_load32(m + 32), reinterpret_cast<const char*>(m + 24)});
+                continue;
+            case ITCH_ORDER_EXECUTED:
+                if (LOB_UNLIKELY(length < 31)) break;
+                handler.on_execute(locate, itch_load64(m + 11), itch_load32(m + 19));
+                continue;
+            case ITCH_ORDER_EXECUTED_PRICE:
+                if (LOB_UNLIKELY(length < 36)) break;
+                handler.on_execute(locate, itch_load64(m + 11), itch_load32(m + 19));
+                continue;
+            case ITCH_ORDER_CANCEL:
+                if (LOB_UNLIKELY(length < 23)) break;
+                handler.on_cancel(locate, itch_load64(m + 11), itch_load32(m + 19));
+                continue;
+            case ITCH_ORDER_DELETE:
+                if (LOB_UNLIKELY(length < 19)) break;
+                handler.on_delete(locate, itch_load64(m + 11));
+                continue;
+            case ITCH_ORDER_REPLACE:
+                if (LOB_UNLIKELY(length < 35)) break;
+                handler.on_replace(locate, itch_load64(m + 11), itch_load64(m + 19),
+                                   itch_load32(m + 27), itch_load32(m + 31));
+                continue;
+            case ITCH_STOCK_DIRECTORY:
+                if (LOB_UNLIKELY(length < 19)) break;
+                handler.on_stock_directory(locate, reinterpret_cast<const char*>(m + 11));
+                continue;
+            default:
+                continue;   // system events, trades, NOII, ...: counted only
+        }
+        ++stats.malformed;
+    }
+    stats.bytes = pos;
+    return stats;
+}
+
+/**
+ * ItchFile: read-only memory mapping of a capture, advised for one
+ * sequential pass. is_open() is false if the file cannot be mapped.
+ */
+class ItchFile {
+    private:
+        int fd;
+        const unsigned char* base;
+        size_t length;
+
+    public:
+        explicit ItchFile(const char* path);
+        ~ItchFile();
+
+        ItchFile(const ItchFile&) = delete;
+        ItchFile& operator=(const ItchFile&) = delete;
+
+        bool is_open() const { return base != nullptr; }
+        const unsigned char* data() const { return base; }
+        size_t size() const { return length; }
+
+        template<typename Handler>
+        ItchParseStats parse(Handler& handler) const { return parse_itch(base, length, handler); }
+};
+
+using ItchBook = BasicBook<FifoMatching, NullEventSink>;
+extern template class BasicBook<FifoMatching, NullEventSink>;
+
+/**
+ * ItchBookBuilder: market-by-order reconstruction, one ItchBook per stock
+ * locate code, created on the locate's first Add Order.
+ *
+ * The feed reports the exchange's own executions, so the books must never
+ * match: they are kept in auction mode, where orders only rest. Executions
+ * and partial cancels shrink the order in place (keeping its priority),
+ * deletes remove it, and a replace removes the old reference and adds the
+ * new one on the same side at the back of its level, as on the exchange.
+ * References not found in the book (e.g. a capture joined mid-day) are
+ * counted and ignored.
+ */
+class ItchBookBuilder : public NullItchHandler {
+    private:
+        std::vector<std::unique_ptr<ItchBook>> books;   // by locate
+        std::vector<std::array<char, 8>> symbols;       // by locate (from 'R')
+        size_t book_capacity;
+        size_t book_count;
+        std::uint64_t unknown_orders;
+
+        ItchBook& book_for(std::uint16_t locate) {
+            std::unique_ptr<ItchBook>& book = books[locate];
+            if (LOB_UNLIKELY(!book)) create_book(locate);
+            return *book;
+        }
+        void create_book(std::uint16_t locate);
+        void reduce(std::uint16_t locate, ID order_ref, Volume shares);
+
+    public:
+        /** @param book_capacity initial order pool size of each book */
+        explicit ItchBookBuilder(size_t book_capacity = 1024);
+
+        void on_stock_directory(std::uint16_t locate, const char* stock);
+        void on_add(const ItchAddOrder& add) {
+            book_for(add.locate).place_order(add.order_ref, 0, add.side, add.price, add.shares);
+        }
+        void on_execute(std::uint16_t locate, ID order_ref, Volume shares) { reduce(locate, order_ref, shares); }
+        void on_cancel(std::uint16_t locate, ID order_ref, Volume shares) { reduce(locate, order_ref, shares); }
+        void on_delete(std::uint16_t locate, ID order_ref);
+        void on_replace(std::uint16_t locate, ID old_ref, ID new_ref, Volume shares, PRICE price);
+
+        /** Null if no message for this locate has been seen */
+        ItchBook* get_book(std::uint16_t locate) { return books[locate].get(); }
+        /** Symbol from the stock directory, trailing spaces removed ("" if unknown) */
+        std::string get_symbol(std::uint16_t locate) const;
+        size_t get_book_count() const { return book_count; }
+        size_t get_resting_orders_count() const;
+        std::uint64_t get_unknown_orders() const { return unknown_orders; }
+};
+
+/**
+ * ItchWriter: encodes ITCH 5.0 messages (with length prefixes) into a
+ * buffer, for synthetic captures and tests. Tracking numbers are zero.
+ */
+class ItchWriter {
+    private:
+        std::vector<unsigned char> buffer;
+
+        unsigned char* begin_message(char type, std::uint16_t locate, Timestamp timestamp, size_t length);
+
+    public:
+        void stock_directory(std::uint16_t locate, Timestamp timestamp, const char* stock);
+        void system_event(Timestamp timestamp, char event_code);
+        void add_order(std::uint16_t locate, Timestamp timestamp, ID order_ref, OrderType side,
+                       Volume shares, const char* stock, PRICE price);
+        void order_executed(std::uint16_t locate, Timestamp timestamp, ID order_ref, Volume shares,
+                            std::uint64_t match_number);
+        void order_cancel(std::uint16_t locate, Timestamp timestamp, ID order_ref, Volume shares);
+        void order_delete(std::uint16_t locate, Timestamp timestamp, ID order_ref);
+        void order_replace(std::uint16_t locate, Timestamp timestamp, ID old_ref, ID new_ref,
+                           Volume shares, PRICE price);
+
+        const std::vector<unsigned char>& get_buffer() const { return buffer; }
+        void clear() { buffer.clear(); }
+};
+
+#endif // LOB_ITCH_H
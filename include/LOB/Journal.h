@@ -0,0 +1,161 @@
+#ifndef LOB_JOURNAL_H
+#define LOB_JOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Command.h"
+#include "Macros.h"
+
+/**
+ * One journal slot: the command and its 1-based position. A slot is valid
+ * only if `index` matches its position, so a torn or never-written slot
+ * (the file is zero-filled) ends recovery cleanly.
+ */
+struct JournalRecord {
+    Command command;
+    std::uint64_t index;
+};
+
+static_assert(sizeof(JournalRecord) == 64, "JournalRecord is one cache line");
+static_assert(std::is_trivially_copyable<JournalRecord>::value, "JournalRecord is copied bytewise");
+
+/** First 64 bytes of a journal file; records follow */
+struct JournalHeader {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t capacity;
+    std::uint64_t reserved[5];
+};
+
+static_assert(sizeof(JournalHeader) == 64, "JournalHeader is one cache line");
+
+constexpr std::uint64_t JOURNAL_MAGIC = 0x314C4E524A424F4CULL; // "LOBJRNL1"
+constexpr std::uint32_t JOURNAL_VERSION = 1;
+
+/**
+ * Journal: append-only write-ahead log of inbound Commands in a pre-sized,
+ * memory-mapped file of fixed-size records.
+ *
+ * append() is a 64-byte copy into the mapping plus a release store; it never
+ * calls into the kernel. A background thread (start()) msyncs newly appended
+ * records in groups every flush interval and advances get_durable(). Each
+ * flush also prefaults the next PREFAULT_BYTES past the writer, writable and
+ * without touching the data, so appends rarely take page faults; opening a
+ * journal costs that window rather than the whole file, and pages the writer
+ * never reaches stay clean.
+ *
+ * Opening an existing journal recovers its valid prefix: replay() hands the
+ * recovered commands back and appends continue after them.
+ *
+ * append() and replay() belong to one thread (the matching thread); flush()
+ * may run on any thread, but only one at a time.
+ */
+class Journal {
+    private:
+        static constexpr size_t PREFAULT_BYTES = size_t(4) << 20;
+
+        int fd;
+        unsigned char* base;
+        size_t map_bytes;
+        size_t prefault_end;    // mapping bytes prefaulted so far (flush() side)
+        JournalRecord* records;
+        std::uint64_t capacity;
+        std::uint64_t recovered;
+        std::chrono::microseconds flush_interval;
+
+        // Writer side
+        alignas(LOB_CACHE_LINE) std::uint64_t write_index;
+        // Flusher side
+        alignas(LOB_CACHE_LINE) std::atomic<std::uint64_t> published;
+        alignas(LOB_CACHE_LINE) std::atomic<std::uint64_t> durable;
+        std::atomic<bool> running;
+        std::thread flusher;
+
+        bool map_file(const char* path, size_t requested_capacity);
+        void prefault(std::uint64_t from_record);
+        void run();
+
+    public:
+        /**
+         * @param path journal file, created (and sized) if it does not exist
+         * @param capacity records to reserve for a new file; an existing
+         *        journal keeps its own capacity
+         * @param flush_interval group-commit period of the flusher thread
+         */
+        Journal(const char* path, size_t capacity,
+                std::chrono::microseconds flush_interval = std::chrono::microseconds(1000));
+        ~Journal();
+
+        Journal(const Journal&) = delete;
+        Journal& operator=(const Journal&) = delete;
+
+        /** False if the file could not be created or mapped (appends then fail) */
+        bool is_open() const { return records != nullptr; }
+
+        /**
+         * @brief Appends one command; durable after the next flush
+         * @return false if the journal is full or not open
+         */
+        bool append(const Command& command) {
+            if (LOB_UNLIKELY(write_index >= capacity)) {
+                return false;
+            }
+            JournalRecord record;
+            record.command = command;
+            record.index = write_index + 1;
+            std::memcpy(&records[write_index], &record, sizeof(JournalRecord));
+            ++write_index;
+            published.store(write_index, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Calls fn(const Command&) for every record appended so far, oldest first
+         * @param from records to skip (e.g. the journal position of a snapshot)
+         * @return number of records replayed
+         */
+        template<typename Fn>
+        size_t replay(Fn&& fn, std::uint64_t from = 0) const {
+            for (std::uint64_t i = from; i < write_index; ++i) {
+                fn(records[i].command);
+            }
+            return from < write_index ? write_index - from : 0;
+        }
+
+        /**
+         * @brief Writes back every record published so far (one msync), then
+         * prefaults the window ahead of the writer
+         * @return number of records made durable by this call
+         */
+        size_t flush();
+
+        /** Starts the group-commit thread */
+        void start();
+
+        /** Stops the group-commit thread after a final flush */
+        void stop();
+
+        /** True if the next append() would fail (full, or not open); writer thread only */
+        bool is_full() const { return write_index >= capacity; }
+
+        std::uint64_t get_capacity() const { return capacity; }
+        /** Valid records found when the file was opened */
+        std::uint64_t get_recovered() const { return recovered; }
+        std::uint64_t get_appended() const { return published.load(std::memory_order_acquire); }
+        std::uint64_t get_durable() const { return durable.load(std::memory_order_acquire); }
+};
+
+/**
+ * @brief Reads the valid prefix of a journal file into `out` without mapping
+ * it writable (for offline replay tools)
+ * @return false if the file is missing or not a journal
+ */
+bool read_journal(const char* path, std::vector<Command>& out);
+
+#endif // LOB_JOURNAL_H
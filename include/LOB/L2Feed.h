@@ -0,0 +1,81 @@
+#ifndef LOB_L2_FEED_H
+#define LOB_L2_FEED_H
+
+#include <cstdint>
+#include <vector>
+#include "Types.h"
+#include "EventSink.h"
+#include "FlatHashMap.h"
+
+/**
+ * LevelUpdate: market-by-price delta for one level. volume and order_count
+ * cover displayed orders only. A level with order_count == 0 has no displayed
+ * orders left and is deleted from the feed.
+ */
+struct LevelUpdate {
+    PRICE price;
+    OrderType side;
+    Volume volume;
+    Length order_count;
+};
+
+/**
+ * L2Conflator: event sink that keeps only the latest state of each level
+ * touched since the last flush(). A sweep through many levels or many fills
+ * at one level therefore publishes one update per level per batch, in the
+ * order the levels were first touched.
+ */
+class L2Conflator : public NullEventSink {
+    private:
+        FlatHashMap<std::uint64_t, size_t> index; // (side, price) -> pending slot
+        std::vector<LevelUpdate> pending;
+        std::vector<std::uint64_t> dirty;         // keys in index, erased on flush
+
+        static std::uint64_t key(OrderType side, PRICE price) {
+            return (static_cast<std::uint64_t>(side) << 32) | price;
+        }
+
+    public:
+        explicit L2Conflator(size_t expected_levels = 64) {
+            index.reserve(expected_levels);
+            pending.reserve(expected_levels);
+            dirty.reserve(expected_levels);
+        }
+
+        void on_level_update(OrderType side, const Level& level) {
+            LevelUpdate update{level.get_price(), side, level.get_displayed_volume(),
+                               level.get_displayed_order_number()};
+            std::uint64_t k = key(side, level.get_price());
+            auto it = index.find(k);
+            if (it != index.end()) {
+                pending[it->second] = update;
+            } else {
+                index[k] = pending.size();
+                pending.push_back(update);
+                dirty.push_back(k);
+            }
+        }
+
+        /**
+         * @brief Hands every conflated update to fn and starts a new batch
+         * Costs the number of touched levels, not the index capacity.
+         * @return number of updates published
+         */
+        template<typename Fn>
+        size_t flush(Fn&& fn) {
+            for (const LevelUpdate& update : pending) {
+                fn(update);
+            }
+            size_t published = pending.size();
+            for (std::uint64_t k : dirty) {
+                index.erase(k);
+            }
+            dirty.clear();
+            pending.clear();
+            return published;
+        }
+
+        size_t get_pending_count() const { return pending.size(); }
+};
+
+#endif // LOB_L2_FEED_H
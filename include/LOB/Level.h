@@ -3,6 +3,7 @@
 
 #include "Order.h"
 #include "Trade.h"
+#include "Macros.h"
 
 /**
  * Level: Represents a price level in the order book.
@@ -13,14 +14,18 @@
  * Invariants:
  * - head points to oldest order (first to match), tail to newest
  * - If level is non-empty, head and tail are non-null
- * - total_volume == sum of remaining_volume of all orders
+ * - displayed_volume == sum of displayed volume of all orders
+ * - hidden_volume == sum of hidden volume (iceberg reserves, hidden orders)
  * - order_number == count of orders in the list
+ * - displayed_orders == count of orders in the list that are not hidden
  */
 class Level {
     private:
         PRICE limit_price; /**< Limit price */
         Length order_number; /**< Number of orders at this limit */
-        Volume total_volume; /**< Total volume at this limit */
+        Length displayed_orders; /**< Orders at this limit that are not hidden */
+        Volume displayed_volume; /**< Displayed volume at this limit */
+        Volume hidden_volume; /**< Hidden volume at this limit (reserves, hidden orders) */
 
         Order* head; /**< First order in the list (oldest, FIFO) */
         Order* tail; /**< Last order in the list (most recent) */
@@ -32,7 +37,9 @@ class Level {
         Level(PRICE price):
             limit_price(price),
             order_number(0),
-            total_volume(0),
+            displayed_orders(0),
+            displayed_volume(0),
+            hidden_volume(0),
             head(nullptr),
             tail(nullptr),
             prev_level(nullptr),
@@ -58,12 +65,28 @@ class Level {
         void erase(Order* order);
         
         /**
-         * @brief Decreases total volume (used during matching)
+         * @brief Decreases displayed volume (used during matching)
          * @param volume volume to subtract
          */
         void decrease_volume(Volume volume) {
-            total_volume -= volume;
+            displayed_volume -= volume;
         }
+
+        /**
+         * @brief Decreases the volume of a filled order on the matching side
+         * @param order order that was filled (hidden orders draw on hidden volume)
+         * @param volume volume to subtract
+         */
+        void decrease_volume(const Order* order, Volume volume) {
+            if (LOB_UNLIKELY(order->is_hidden())) hidden_volume -= volume;
+            else displayed_volume -= volume;
+        }
+
+        /**
+         * @brief Re-queues a fully filled iceberg tip at the tail with a fresh tip
+         * @param order iceberg order in this level with reserve left
+         */
+        void replenish(Order* order);
         
         /**
          * @brief Checks if the level is empty (i.e. no orders)
@@ -73,8 +96,12 @@ class Level {
 
         /** Getters */
         PRICE get_price() const { return limit_price; }
+        void set_price(PRICE price) { limit_price = price; } // peg queues follow their reference
         Length get_order_number() const { return order_number; }
-        Volume get_total_volume() const { return total_volume; }
+        Length get_displayed_order_number() const { return displayed_orders; }
+        Volume get_total_volume() const { return displayed_volume + hidden_volume; }
+        Volume get_displayed_volume() const { return displayed_volume; }
+        Volume get_hidden_volume() const { return hidden_volume; }
         
         Order* get_head() const { return head; }
         Order* get_tail() const { return tail; }
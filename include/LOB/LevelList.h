@@ -0,0 +1,81 @@
+#ifndef LOB_LEVEL_LIST_H
+#define LOB_LEVEL_LIST_H
+
+#include "Level.h"
+
+/**
+ * Intrusive sorted level lists (Level prev/next links), shared by the matching
+ * book and its replicas. Inserts walk from the head, so new levels near the
+ * touch are O(1) in practice.
+ */
+
+// Descending price order (head = highest): buy levels, sell stop triggers
+inline void insert_level_descending(Level*& head, Level* level) {
+    PRICE price = level->get_price();
+
+    // Empty list or new highest price
+    if (!head || price > head->get_price()) {
+        level->set_next_level(head);
+        level->set_prev_level(nullptr);
+        if (head) head->set_prev_level(level);
+        head = level;
+        return;
+    }
+
+    // Walk to find insertion point (descending order)
+    Level* cur = head;
+    while (cur->get_next_level() && cur->get_next_level()->get_price() > price) {
+        cur = cur->get_next_level();
+    }
+    // Insert after cur
+    level->set_next_level(cur->get_next_level());
+    level->set_prev_level(cur);
+    if (cur->get_next_level()) cur->get_next_level()->set_prev_level(level);
+    cur->set_next_level(level);
+}
+
+// Ascending price order (head = lowest): sell levels, buy stop triggers
+inline void insert_level_ascending(Level*& head, Level* level) {
+    PRICE price = level->get_price();
+
+    // Empty list or new lowest price
+    if (!head || price < head->get_price()) {
+        level->set_next_level(head);
+        level->set_prev_level(nullptr);
+        if (head) head->set_prev_level(level);
+        head = level;
+        return;
+    }
+
+    // Walk to find insertion point (ascending order)
+    Level* cur = head;
+    while (cur->get_next_level() && cur->get_next_level()->get_price() < price) {
+        cur = cur->get_next_level();
+    }
+    // Insert after cur
+    level->set_next_level(cur->get_next_level());
+    level->set_prev_level(cur);
+    if (cur->get_next_level()) cur->get_next_level()->set_prev_level(level);
+    cur->set_next_level(level);
+}
+
+inline void unlink_level(Level*& head, Level* level) {
+    Level* prev = level->get_prev_level();
+    Level* next = level->get_next_level();
+    if (prev) prev->set_next_level(next);
+    else head = next; // was head
+    if (next) next->set_prev_level(prev);
+    level->set_prev_level(nullptr);
+    level->set_next_level(nullptr);
+}
+
+// Appends below the current tail; for loading levels already in list order
+inline void append_level(Level*& head, Level*& tail, Level* level) {
+    level->set_prev_level(tail);
+    level->set_next_level(nullptr);
+    if (tail) tail->set_next_level(level);
+    else head = level;
+    tail = level;
+}
+
+#endif // LOB_LEVEL_LIST_H
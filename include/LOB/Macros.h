@@ -9,4 +9,22 @@
     #define LOB_UNLIKELY(x) (x)
 #endif
 
+// Spin-wait hint for busy loops on shared queues
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define LOB_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__)
+    #define LOB_CPU_RELAX() asm volatile("yield" ::: "memory")
+#else
+    #define LOB_CPU_RELAX() ((void)0)
+#endif
+
+// Destructive interference size used to pad shared atomics
+#define LOB_CACHE_LINE 64
+
+// Self-trade prevention check in the matching loop; define to 0 to compile it out
+#ifndef LOB_ENABLE_STP
+    #define LOB_ENABLE_STP 1
+#endif
+
 #endif // LOB_MACROS_H
@@ -0,0 +1,52 @@
+#ifndef LOB_MATCHING_POLICY_H
+#define LOB_MATCHING_POLICY_H
+
+#include "Types.h"
+
+/**
+ * Matching policies: compile-time selection of how an incoming order is
+ * allocated across the resting orders of one price level (BasicBook template
+ * parameter). Price priority across levels is the same for every policy.
+ */
+
+/**
+ * FifoMatching: strict price-time priority (default).
+ */
+struct FifoMatching {
+    static constexpr bool pro_rata = false;
+    static constexpr unsigned top_order_percent = 0;
+    static constexpr Volume min_allocation = 0;
+};
+
+/**
+ * ProRataMatching: allocates across a level in proportion to displayed size.
+ *
+ * TOP_ORDER_PERCENT: share of the incoming volume first offered to the order
+ *                    at the head of the level (0 disables top-order allocation)
+ * MIN_ALLOCATION:    pro-rata shares below this are not allocated
+ *
+ * Rounding residue and hidden volume are then allocated FIFO.
+ */
+template<unsigned TOP_ORDER_PERCENT = 0, Volume MIN_ALLOCATION = 1>
+struct ProRataMatching {
+    static_assert(TOP_ORDER_PERCENT <= 100, "Top-order share is a percentage");
+
+    static constexpr bool pro_rata = true;
+    static constexpr unsigned top_order_percent = TOP_ORDER_PERCENT;
+    static constexpr Volume min_allocation = MIN_ALLOCATION;
+};
+
+/**
+ * @brief floor(order_volume * allocate / base) without 64-bit overflow
+ */
+inline Volume pro_rata_share(Volume order_volume, Volume allocate, Volume base) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<Volume>(
+        (static_cast<unsigned __int128>(order_volume) * allocate) / base);
+#else
+    return static_cast<Volume>(
+        (static_cast<long double>(order_volume) * allocate) / base);
+#endif
+}
+
+#endif // LOB_MATCHING_POLICY_H
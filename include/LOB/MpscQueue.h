@@ -0,0 +1,137 @@
+#ifndef LOB_MPSC_QUEUE_H
+#define LOB_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include "Macros.h"
+
+/**
+ * MpscQueue: bounded multi-producer / single-consumer queue (Vyukov-style).
+ *
+ * Every cell carries a turn counter. A producer claims the next position with
+ * one CAS on the shared enqueue index, writes its cell and publishes it by
+ * advancing the cell's turn; producers never wait for each other's writes.
+ * The consumer takes cells strictly in claim order, so a slow producer holds
+ * back later ones and the drained order is exactly the claim order.
+ *
+ * If T has a `sequence` member it is stamped with the claimed position at
+ * enqueue: a gap-free, total order of all producers' input for replay.
+ * Cells are padded to cache lines so neighbouring producers do not share one.
+ */
+template<typename T>
+class MpscQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "MpscQueue cells are copied bytewise");
+
+    private:
+        struct alignas(LOB_CACHE_LINE) Cell {
+            std::atomic<std::uint64_t> turn;
+            T value;
+        };
+
+        const std::uint64_t mask;
+        std::unique_ptr<Cell[]> cells;
+
+        alignas(LOB_CACHE_LINE) std::atomic<std::uint64_t> enqueue_pos;
+        // Written by the consumer only; atomic so size() may read it from any thread
+        alignas(LOB_CACHE_LINE) std::atomic<std::uint64_t> dequeue_pos;
+
+        static std::uint64_t round_up_pow2(size_t n) {
+            std::uint64_t capacity = 2;
+            while (capacity < n) capacity <<= 1;
+            return capacity;
+        }
+
+    public:
+        explicit MpscQueue(size_t capacity)
+            : mask(round_up_pow2(capacity) - 1),
+              cells(new Cell[mask + 1]),
+              enqueue_pos(0),
+              dequeue_pos(0) {
+            for (std::uint64_t i = 0; i <= mask; ++i) {
+                cells[i].turn.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        /** Producer (any thread): enqueue one element, false if the queue is full */
+        bool try_push(const T& value) {
+            std::uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true) {
+                cell = &cells[pos & mask];
+                std::uint64_t turn = cell->turn.load(std::memory_order_acquire);
+                auto diff = static_cast<std::int64_t>(turn - pos);
+                if (diff == 0) {
+                    if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false; // the consumer has not released this cell yet
+                } else {
+                    pos = enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = value;
+            if constexpr (requires { cell->value.sequence; }) {
+                cell->value.sequence = pos;
+            }
+            cell->turn.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Producer (any thread): enqueue one element, spinning while the queue is full */
+        void push(const T& value) {
+            unsigned spins = 0;
+            while (!try_push(value)) {
+                if (++spins < 64) {
+                    LOB_CPU_RELAX();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        /**
+         * Consumer: hand up to max_batch published elements to fn in claim order.
+         * Stops early at a claimed cell whose producer has not finished writing.
+         * If fn returns bool, false declines the element: it stays queued and
+         * the batch ends there.
+         * @return number of elements consumed
+         */
+        template<typename Fn>
+        size_t consume(Fn&& fn, size_t max_batch = static_cast<size_t>(-1)) {
+            std::uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+            size_t n = 0;
+            while (n < max_batch) {
+                Cell& cell = cells[pos & mask];
+                if (cell.turn.load(std::memory_order_acquire) != pos + 1) break;
+                if constexpr (std::is_same<std::invoke_result_t<Fn&, const T&>, bool>::value) {
+                    if (!fn(static_cast<const T&>(cell.value))) break;
+                } else {
+                    fn(static_cast<const T&>(cell.value));
+                }
+                cell.turn.store(pos + mask + 1, std::memory_order_release);
+                dequeue_pos.store(++pos, std::memory_order_release);
+                ++n;
+            }
+            return n;
+        }
+
+        size_t capacity() const { return mask + 1; }
+
+        /** Elements claimed but not yet consumed, from any thread (approximate while either side runs) */
+        size_t size() const {
+            // Consumer position first: it never passes the enqueue index read after it
+            std::uint64_t consumed = dequeue_pos.load(std::memory_order_acquire);
+            return enqueue_pos.load(std::memory_order_acquire) - consumed;
+        }
+};
+
+#endif // LOB_MPSC_QUEUE_H
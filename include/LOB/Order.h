@@ -14,6 +14,7 @@ class Order;
  * 
  * Invariants:
  * - prev_order and next_order are either nullptr or point to valid Orders in the same Level
+ * - remaining_volume is the displayed tip; reserve_volume is only non-zero for resting icebergs
  * - Order lifetime is managed by Book's SlabPool
  */
 class Order {
@@ -25,10 +26,20 @@ class Order {
         Volume initial_volume; /**< Initial volume/number of shares in the order */
         Volume remaining_volume; /**< Volume/number of remaining shares in the order */
         OrderStatus order_status; /**< Current status of the order */
+        Volume display_volume; /**< Iceberg tip size (0 for a fully displayed order) */
+        Volume reserve_volume; /**< Iceberg volume held back from the displayed tip */
+        bool hidden; /**< Hidden order: remaining volume is never displayed */
+        PRICE trigger_price; /**< Stop trigger price (0 if not a stop order) */
+        Timestamp expire_time; /**< Good-till-time expiry (0 for good-till-cancel) */
+        PegType peg_type; /**< Peg reference (PEG_NONE for a plain limit order) */
         
         /** Intrusive doubly-linked list for FIFO ordering at same price level */
         Order* prev_order; /**< Previous order in the list (nullptr if first) */
         Order* next_order; /**< Next order in the list (nullptr if last) */
+
+        /** Intrusive doubly-linked list for the book's timing wheel slot */
+        Order* timer_prev; /**< Previous order in the same wheel slot */
+        Order* timer_next; /**< Next order in the same wheel slot */
         
     public:
         Order(
@@ -38,7 +49,9 @@ class Order {
             PRICE order_price,
             Volume initial_volume,
             Volume remaining_volume,
-            OrderStatus order_status)
+            OrderStatus order_status,
+            Volume display_volume = 0,
+            bool hidden = false)
             :
             order_id(order_id),
             agent_id(agent_id),
@@ -47,8 +60,16 @@ class Order {
             initial_volume(initial_volume),
             remaining_volume(remaining_volume),
             order_status(order_status),
+            display_volume(display_volume),
+            reserve_volume(0),
+            hidden(hidden),
+            trigger_price(0),
+            expire_time(0),
+            peg_type(PEG_NONE),
             prev_order(nullptr),
-            next_order(nullptr) 
+            next_order(nullptr),
+            timer_prev(nullptr),
+            timer_next(nullptr)
         {}
         
         /**
@@ -57,12 +78,33 @@ class Order {
          */
         void fill(Volume fill_volume);
 
+        /**
+         * @brief reduces the remaining volume without a trade (e.g. STP decrement)
+         * @param volume: Volume to remove; the order is DELETED once nothing remains
+         */
+        void reduce(Volume volume);
+
+        /**
+         * @brief cancels the order's remaining volume and marks it DELETED
+         */
+        void cancel();
+
         /**
          * @brief checks if the order is fulfilled
          * @return true if the order is fulfilled, false otherwise
          */
         bool is_fulfilled() const;
 
+        /**
+         * @brief moves volume above the iceberg tip size into the reserve (on resting)
+         */
+        void hold_reserve();
+
+        /**
+         * @brief refills a fully filled iceberg tip from the reserve
+         */
+        void replenish();
+
         /** Getters and setters */
         ID get_order_id() const;
         ID get_agent_id() const;
@@ -73,6 +115,33 @@ class Order {
         OrderStatus get_order_status() const;
 
         void set_order_status(OrderStatus order_status);
+
+        // Stop order accessors; a pending stop-market order has order_price 0
+        PRICE get_trigger_price() const { return trigger_price; }
+        void set_trigger_price(PRICE price) { trigger_price = price; }
+        void set_order_price(PRICE price) { order_price = price; }
+
+        // Pegged orders have no fixed order_price; the book derives it on match
+        PegType get_peg_type() const { return peg_type; }
+        void set_peg_type(PegType type) { peg_type = type; }
+
+        // Good-till-time accessors
+        Timestamp get_expire_time() const { return expire_time; }
+        void set_expire_time(Timestamp time) { expire_time = time; }
+        Order* get_timer_prev() const { return timer_prev; }
+        void set_timer_prev(Order* prev) { timer_prev = prev; }
+        Order* get_timer_next() const { return timer_next; }
+        void set_timer_next(Order* next) { timer_next = next; }
+
+        // Iceberg/hidden accessors (used for Level volume accounting)
+        bool is_hidden() const { return hidden; }
+        bool is_iceberg() const { return display_volume != 0; }
+        Volume get_display_volume() const { return display_volume; }
+        Volume get_reserve_volume() const { return reserve_volume; }
+        /** Restores a held-back reserve (snapshot load only; the order must not be on a level) */
+        void set_reserve_volume(Volume volume) { reserve_volume = volume; }
+        Volume get_displayed_volume() const { return hidden ? 0 : remaining_volume; }
+        Volume get_hidden_volume() const { return hidden ? remaining_volume : reserve_volume; }
         
         // Intrusive list accessors (for Level class)
         Order* get_prev_order() const { return prev_order; }
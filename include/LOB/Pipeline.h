@@ -0,0 +1,245 @@
+#ifndef LOB_PIPELINE_H
+#define LOB_PIPELINE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include "EngineRunner.h"
+
+inline std::uint64_t steady_now_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+enum PipelineStage { STAGE_DECODE, STAGE_RISK, STAGE_MATCH, STAGE_PUBLISH, STAGE_COUNT };
+
+/**
+ * Per-stage counters, written only by the stage's own thread.
+ * - items / batches: records handled and non-empty polls
+ * - busy_ns:         time spent handling batches (utilization = busy / wall)
+ * - depth_sum:       input ring depth summed over non-empty polls (occupancy)
+ * - max_depth:       deepest input ring seen
+ * - latency_ns_sum:  submit-stamp-to-stage-exit time summed over items,
+ *                    input queueing included (decode, risk, match; reports
+ *                    carry no stamp)
+ * - rejected:        records dropped by the stage (decode errors, risk rejects)
+ */
+struct alignas(LOB_CACHE_LINE) StageCounters {
+    std::atomic<std::uint64_t> items{0};
+    std::atomic<std::uint64_t> batches{0};
+    std::atomic<std::uint64_t> busy_ns{0};
+    std::atomic<std::uint64_t> depth_sum{0};
+    std::atomic<std::uint64_t> max_depth{0};
+    std::atomic<std::uint64_t> latency_ns_sum{0};
+    std::atomic<std::uint64_t> rejected{0};
+};
+
+/** Plain copy of StageCounters with derived averages */
+struct StageStats {
+    std::uint64_t items;
+    std::uint64_t batches;
+    std::uint64_t busy_ns;
+    std::uint64_t max_depth;
+    std::uint64_t rejected;
+    double mean_depth;          // average input occupancy when work was found
+    double mean_latency_ns;     // average submit-to-exit latency
+};
+
+/**
+ * Pipeline: decode -> risk -> match -> publish, one (optionally pinned)
+ * thread per stage, joined by SPSC rings of preallocated records.
+ *
+ * - Decode:  bool(const Raw&, Command&); false drops the record
+ * - Risk:    bool(Command&); false rejects the command before matching
+ * - Publish: void(const ExecutionReport&)
+ *
+ * The match stage only applies commands to its book (ExecutionReportSink
+ * into the publish ring). submit() stamps each raw record on entry and decode
+ * carries the stamp into Command::timestamp, so every stage's latency counter
+ * runs from submission (the decode counter covers queueing plus decode).
+ * stop() drains the stages front to back, so every submitted record is fully
+ * processed.
+ */
+template<typename Raw, typename Decode, typename Risk, typename Publish>
+class Pipeline {
+    private:
+        static constexpr size_t BATCH_SIZE = 64;
+
+        // Raw record plus the time it was submitted
+        struct Submitted {
+            Raw raw;
+            std::uint64_t submitted_ns;
+        };
+
+        SpscRing<Submitted> input;
+        CommandRing decoded;
+        CommandRing approved;
+        ExecutionRing reports;
+        RunnerBook book;
+
+        Decode decode;
+        Risk risk;
+        Publish publish;
+
+        std::array<int, STAGE_COUNT> cpus;
+        WaitStrategy wait_strategy;
+        std::array<StageCounters, STAGE_COUNT> counters;
+        std::array<std::atomic<bool>, STAGE_COUNT> running;
+        std::array<std::thread, STAGE_COUNT> workers;
+
+        template<typename In, typename Fn>
+        void run_stage(PipelineStage stage, SpscRing<In>& in, Fn&& handle) {
+            if (cpus[stage] >= 0) {
+                pin_current_thread(cpus[stage]);
+            }
+            StageCounters& c = counters[stage];
+            auto poll = [&]() -> size_t {
+                size_t depth = in.size();
+                std::uint64_t start = steady_now_ns();
+                size_t n = in.consume(handle, BATCH_SIZE);
+                if (n != 0) {
+                    c.items.fetch_add(n, std::memory_order_relaxed);
+                    c.batches.fetch_add(1, std::memory_order_relaxed);
+                    c.busy_ns.fetch_add(steady_now_ns() - start, std::memory_order_relaxed);
+                    c.depth_sum.fetch_add(depth, std::memory_order_relaxed);
+                    if (depth > c.max_depth.load(std::memory_order_relaxed)) {
+                        c.max_depth.store(depth, std::memory_order_relaxed);
+                    }
+                }
+                return n;
+            };
+
+            unsigned idle_rounds = 0;
+            while (running[stage].load(std::memory_order_acquire)) {
+                if (poll() != 0) {
+                    idle_rounds = 0;
+                } else {
+                    idle_wait(wait_strategy, idle_rounds++);
+                }
+            }
+            while (poll() != 0) {}
+        }
+
+        void add_latency(PipelineStage stage, const Command& command) {
+            counters[stage].latency_ns_sum.fetch_add(steady_now_ns() - command.timestamp,
+                                                     std::memory_order_relaxed);
+        }
+
+        void decode_stage() {
+            run_stage(STAGE_DECODE, input, [this](const Submitted& item) {
+                Command command{};
+                if (!decode(item.raw, command)) {
+                    counters[STAGE_DECODE].rejected.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                command.timestamp = item.submitted_ns;
+                decoded.push(command);
+                add_latency(STAGE_DECODE, command);
+            });
+        }
+
+        void risk_stage() {
+            run_stage(STAGE_RISK, decoded, [this](const Command& in) {
+                Command command = in;
+                if (!risk(command)) {
+                    counters[STAGE_RISK].rejected.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                approved.push(command);
+                add_latency(STAGE_RISK, command);
+            });
+        }
+
+        void match_stage() {
+            run_stage(STAGE_MATCH, approved, [this](const Command& command) {
+                apply_command(book, command);
+                add_latency(STAGE_MATCH, command);
+            });
+        }
+
+        void publish_stage() {
+            run_stage(STAGE_PUBLISH, reports, [this](const ExecutionReport& report) {
+                publish(report);
+            });
+        }
+
+    public:
+        /**
+         * @param ring_capacity slots of each inter-stage ring
+         * @param cpus core per stage in PipelineStage order (-1 = not pinned)
+         */
+        Pipeline(
+            Decode decode,
+            Risk risk,
+            Publish publish,
+            size_t ring_capacity = 1 << 14,
+            std::array<int, STAGE_COUNT> cpus = {-1, -1, -1, -1},
+            WaitStrategy wait_strategy = WAIT_BACKOFF,
+            size_t book_capacity = 65536
+        )
+            : input(ring_capacity),
+              decoded(ring_capacity),
+              approved(ring_capacity),
+              reports(ring_capacity * 4),
+              book(book_capacity, ExecutionReportSink(reports)),
+              decode(std::move(decode)),
+              risk(std::move(risk)),
+              publish(std::move(publish)),
+              cpus(cpus),
+              wait_strategy(wait_strategy) {
+            for (auto& flag : running) flag.store(false, std::memory_order_relaxed);
+        }
+
+        ~Pipeline() { stop(); }
+
+        Pipeline(const Pipeline&) = delete;
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        void start() {
+            if (workers[STAGE_DECODE].joinable()) return;
+            for (auto& flag : running) flag.store(true, std::memory_order_release);
+            // Downstream first, so no stage waits on a missing consumer
+            workers[STAGE_PUBLISH] = std::thread([this] { publish_stage(); });
+            workers[STAGE_MATCH] = std::thread([this] { match_stage(); });
+            workers[STAGE_RISK] = std::thread([this] { risk_stage(); });
+            workers[STAGE_DECODE] = std::thread([this] { decode_stage(); });
+        }
+
+        /** Drains and joins the stages front to back */
+        void stop() {
+            for (size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+                running[stage].store(false, std::memory_order_release);
+                if (workers[stage].joinable()) {
+                    workers[stage].join();
+                }
+            }
+        }
+
+        /** Feeder thread only: stamp and enqueue one raw record, spinning while full */
+        void submit(const Raw& raw) { input.push(Submitted{raw, steady_now_ns()}); }
+        bool try_submit(const Raw& raw) { return input.try_push(Submitted{raw, steady_now_ns()}); }
+
+        StageStats get_stats(PipelineStage stage) const {
+            const StageCounters& c = counters[stage];
+            StageStats stats{};
+            stats.items = c.items.load(std::memory_order_relaxed);
+            stats.batches = c.batches.load(std::memory_order_relaxed);
+            stats.busy_ns = c.busy_ns.load(std::memory_order_relaxed);
+            stats.max_depth = c.max_depth.load(std::memory_order_relaxed);
+            stats.rejected = c.rejected.load(std::memory_order_relaxed);
+            stats.mean_depth = stats.batches
+                ? static_cast<double>(c.depth_sum.load(std::memory_order_relaxed)) / stats.batches : 0.0;
+            std::uint64_t passed = stats.items - stats.rejected;
+            stats.mean_latency_ns = passed
+                ? static_cast<double>(c.latency_ns_sum.load(std::memory_order_relaxed)) / passed : 0.0;
+            return stats;
+        }
+
+        /** The matching book; only safe to use while the pipeline is stopped */
+        RunnerBook& get_book() { return book; }
+};
+
+#endif // LOB_PIPELINE_H
@@ -0,0 +1,80 @@
+#ifndef LOB_REPLICA_BOOK_H
+#define LOB_REPLICA_BOOK_H
+
+#include <cstdint>
+#include <span>
+#include "Book.h"
+#include "BookEvent.h"
+
+/**
+ * ReplicaBook: read-only copy of a book's resting levels and queues, rebuilt
+ * from the primary's BookEvent stream (see BookEventSink).
+ *
+ * Meant to serve depth and order queries on another core so query traffic
+ * never touches the matching thread. It does no matching of its own: every
+ * change is applied exactly as the primary reported it, with the same Order and
+ * Level types, so after applying sequence N its state_hash() equals the
+ * primary's right after it emitted event N.
+ *
+ * Peg queues are not mirrored (their orders never sit on a level); events for
+ * unknown order ids (incoming orders, pegs) are ignored.
+ */
+class ReplicaBook {
+    private:
+        PriceLevelMap buy_side_limits;
+        PriceLevelMap sell_side_limits;
+        Level* buy_list_head;   // highest buy level (descending order)
+        Level* sell_list_head;  // lowest sell level (ascending order)
+        Orders id_to_order;
+
+        SlabPool<Order, 16384> order_pool;
+        SlabPool<Level, 1024> level_pool;
+
+        std::uint64_t last_sequence;
+
+        void rest(const BookEvent& event);
+        void fill(Order* order, Volume volume);
+        void cancel(Order* order, const BookEvent& event);
+        Level* find_level(const Order* order);
+        void remove_order(Level* level, Order* order);
+
+    public:
+        explicit ReplicaBook(size_t initial_capacity = 16384);
+        ~ReplicaBook() = default;
+
+        ReplicaBook(const ReplicaBook&) = delete;
+        ReplicaBook& operator=(const ReplicaBook&) = delete;
+
+        /**
+         * @brief Applies one event; events must arrive in sequence order
+         * @param event next event of the primary's stream
+         */
+        void apply(const BookEvent& event);
+
+        /**
+         * @brief Applies up to `max_batch` events waiting in `ring`
+         * @return number of events applied
+         */
+        size_t poll(BookEventRing& ring, size_t max_batch = 256) {
+            return ring.consume([this](const BookEvent& event) { apply(event); }, max_batch);
+        }
+
+        /** Sequence of the last applied event (0 before the first) */
+        std::uint64_t get_last_sequence() const { return last_sequence; }
+
+        PRICE get_best_buy() const { return buy_list_head ? buy_list_head->get_price() : 0; }
+        PRICE get_best_sell() const { return sell_list_head ? sell_list_head->get_price() : 0; }
+        size_t get_buy_levels_count() const { return buy_side_limits.size(); }
+        size_t get_sell_levels_count() const { return sell_side_limits.size(); }
+        size_t get_resting_orders_count() const { return id_to_order.size(); }
+
+        /** @brief Same contract as BasicBook::snapshot_depth */
+        DepthCount snapshot_depth(size_t depth, std::span<LevelView> bids, std::span<LevelView> asks) const {
+            return DepthCount{copy_depth(buy_list_head, depth, bids), copy_depth(sell_list_head, depth, asks)};
+        }
+
+        /** @brief Same contract as BasicBook::state_hash */
+        std::uint64_t state_hash() const { return hash_book(buy_list_head, sell_list_head); }
+};
+
+#endif // LOB_REPLICA_BOOK_H
@@ -0,0 +1,86 @@
+#ifndef LOB_SEQ_LOCK_H
+#define LOB_SEQ_LOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Macros.h"
+
+/**
+ * SeqLock: single-writer, multi-reader publication of a small POD.
+ *
+ * The writer bumps the sequence to odd, stores the payload and bumps it back
+ * to even; it never waits for readers. A reader copies the payload between
+ * two sequence loads and retries if a write overlapped. The payload is held
+ * as relaxed atomic words so the overlapping copy is not a data race.
+ * Sequence and payload share one cache line when T fits in 56 bytes.
+ */
+template<typename T>
+class alignas(LOB_CACHE_LINE) SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock payload is copied bytewise");
+
+    private:
+        static constexpr size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        std::atomic<std::uint64_t> sequence;
+        std::atomic<std::uint64_t> words[WORDS];
+
+    public:
+        SeqLock() : sequence(0) {
+            for (size_t i = 0; i < WORDS; ++i) words[i].store(0, std::memory_order_relaxed);
+        }
+
+        SeqLock(const SeqLock&) = delete;
+        SeqLock& operator=(const SeqLock&) = delete;
+
+        /** Writer: publish a new value (single writer only) */
+        void store(const T& value) {
+            std::uint64_t buffer[WORDS] = {};
+            std::memcpy(buffer, &value, sizeof(T));
+
+            std::uint64_t seq = sequence.load(std::memory_order_relaxed);
+            sequence.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < WORDS; ++i) {
+                words[i].store(buffer[i], std::memory_order_relaxed);
+            }
+            sequence.store(seq + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Reader: one attempt at a consistent copy
+         * @return false if a write was in progress or overlapped the copy
+         */
+        bool try_load(T& out) const {
+            std::uint64_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) return false;
+
+            std::uint64_t buffer[WORDS];
+            for (size_t i = 0; i < WORDS; ++i) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) != before) return false;
+
+            std::memcpy(&out, buffer, sizeof(T));
+            return true;
+        }
+
+        /** Reader: spin until a consistent copy is taken */
+        T load() const {
+            T value;
+            while (!try_load(value)) {
+                LOB_CPU_RELAX();
+            }
+            return value;
+        }
+
+        /** Number of completed writes */
+        std::uint64_t get_version() const {
+            return sequence.load(std::memory_order_acquire) / 2;
+        }
+};
+
+#endif // LOB_SEQ_LOCK_H
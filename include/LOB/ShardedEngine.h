@@ -0,0 +1,104 @@
+#ifndef LOB_SHARDED_ENGINE_H
+#define LOB_SHARDED_ENGINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "EngineRunner.h"
+
+/**
+ * ShardedEngine: one book per symbol, symbols partitioned across shard
+ * threads (one per core).
+ *
+ * Each shard owns an SPSC ingress ring fed by the single gateway thread and
+ * an egress ExecutionRing; reports carry the symbol_id. A book is only ever
+ * touched by the shard its symbol is routed to, so matching needs no locks.
+ *
+ * The gateway counts messages per symbol. rebalance() drains and stops all
+ * shards, reassigns symbols so that every shard gets a similar message rate
+ * (largest symbols first, each to the least loaded shard, staying put on
+ * ties), then restarts them. Egress rings must keep being drained meanwhile.
+ */
+class ShardedEngine {
+    private:
+        struct Shard {
+            CommandRing ingress;
+            ExecutionRing egress;
+            int cpu;
+            std::thread worker;
+            alignas(LOB_CACHE_LINE) std::atomic<bool> running;
+            std::atomic<std::uint64_t> processed;
+
+            Shard(size_t ring_capacity, int cpu)
+                : ingress(ring_capacity), egress(ring_capacity * 4), cpu(cpu),
+                  running(false), processed(0) {}
+        };
+
+        std::vector<std::unique_ptr<RunnerBook>> books;     // by symbol_id
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::vector<std::uint32_t> symbol_to_shard;         // gateway-owned routing table
+        std::vector<std::uint64_t> symbol_messages;         // gateway-side count since rebalance
+        WaitStrategy wait_strategy;
+        bool started;
+
+        void run_shard(Shard& shard);
+
+    public:
+        /**
+         * @param symbol_count symbols are numbered 0..symbol_count-1
+         * @param shard_count matching threads
+         * @param cpus optional core per shard (missing or -1 = not pinned)
+         * @param ring_capacity ingress slots per shard (egress gets 4x)
+         * @param book_capacity initial order pool size of each book
+         */
+        ShardedEngine(
+            size_t symbol_count,
+            size_t shard_count,
+            WaitStrategy wait_strategy = WAIT_BACKOFF,
+            const std::vector<int>& cpus = {},
+            size_t ring_capacity = 1 << 14,
+            size_t book_capacity = 1024
+        );
+        ~ShardedEngine();
+
+        ShardedEngine(const ShardedEngine&) = delete;
+        ShardedEngine& operator=(const ShardedEngine&) = delete;
+
+        void start();
+
+        /** Applies all queued commands, then joins every shard thread */
+        void stop();
+
+        /**
+         * @brief Routes a command to the shard owning its symbol (gateway thread only)
+         * @return false if symbol_id is unknown
+         */
+        bool submit(const Command& command) {
+            if (LOB_UNLIKELY(command.symbol_id >= books.size())) return false;
+            ++symbol_messages[command.symbol_id];
+            shards[symbol_to_shard[command.symbol_id]]->ingress.push(command);
+            return true;
+        }
+
+        /**
+         * @brief Rebalances symbols across shards by message rate since the last call
+         * Drains and restarts the shards if they were running (gateway thread only).
+         * @return number of symbols that changed shard
+         */
+        size_t rebalance();
+
+        size_t get_shard_count() const { return shards.size(); }
+        size_t get_symbol_count() const { return books.size(); }
+        size_t get_shard_of(std::uint32_t symbol_id) const { return symbol_to_shard[symbol_id]; }
+        ExecutionRing& get_egress(size_t shard) { return shards[shard]->egress; }
+        std::uint64_t get_processed(size_t shard) const {
+            return shards[shard]->processed.load(std::memory_order_acquire);
+        }
+
+        /** A symbol's book; only safe to use while the engine is stopped */
+        RunnerBook& get_book(std::uint32_t symbol_id) { return *books[symbol_id]; }
+};
+
+#endif // LOB_SHARDED_ENGINE_H
@@ -6,6 +6,7 @@
 #include <vector>
 #include <cassert>
 #include <new>
+#include <type_traits>
 #include "Macros.h"
 
 #ifdef __linux__
@@ -18,6 +19,12 @@
  * Template parameter SLAB_SZ controls objects per slab.
  * On Linux, slab storage is allocated via mmap + madvise(MADV_HUGEPAGE)
  * for TLB-friendly large allocations. Falls back to aligned new otherwise.
+ *
+ * Fresh slab storage is handed out by bumping a pointer, so a new slab costs
+ * no page touches until its objects are used; freed objects go to the free
+ * list, which is preferred on allocation. A pool constructed for fewer than
+ * SLAB_SZ objects skips the huge-page advice on its first slab, so many small
+ * pools (e.g. one book per symbol) commit 4 KB pages on demand.
  */
 template<typename T, size_t SLAB_SZ = 1024>
 class SlabPool {
@@ -38,28 +45,31 @@ private:
         char* storage;   // pointer to allocated storage
         bool use_mmap;   // track allocation method for cleanup
 
-        Slab() : storage(nullptr), use_mmap(false) {
-            allocate_storage();
+        explicit Slab(bool huge_pages) : storage(nullptr), use_mmap(false) {
+            allocate_storage(huge_pages);
         }
 
         ~Slab() {
             free_storage();
         }
 
-        void allocate_storage() {
+        void allocate_storage(bool huge_pages) {
 #ifdef __linux__
             void* ptr = ::mmap(nullptr, SLAB_BYTES,
                                PROT_READ | PROT_WRITE,
                                MAP_PRIVATE | MAP_ANONYMOUS,
                                -1, 0);
             if (ptr != MAP_FAILED) {
-                ::madvise(ptr, SLAB_BYTES, MADV_HUGEPAGE);
+                if (huge_pages) {
+                    ::madvise(ptr, SLAB_BYTES, MADV_HUGEPAGE);
+                }
                 storage = static_cast<char*>(ptr);
                 use_mmap = true;
                 return;
             }
 #endif
             // Fallback: aligned allocation
+            (void)huge_pages;
             storage = static_cast<char*>(::operator new(SLAB_BYTES, std::align_val_t{ALIGNMENT}));
             use_mmap = false;
         }
@@ -83,6 +93,9 @@ private:
 
     std::vector<Slab*> slabs_;
     FreeNode* free_list_;
+    char* bump_;        // next never-used object in slab bump_slab_
+    char* bump_end_;
+    size_t bump_slab_;  // slabs after this one are untouched
     size_t total_capacity_;
     size_t allocated_count_;
 
@@ -111,18 +124,30 @@ private:
 public:
     SlabPool(size_t initial_capacity = SLAB_SZ)
         : free_list_(nullptr),
+          bump_(nullptr),
+          bump_end_(nullptr),
+          bump_slab_(static_cast<size_t>(-1)),
           total_capacity_(0),
           allocated_count_(0) {
         size_t initial_slabs = (initial_capacity + SLAB_SZ - 1) / SLAB_SZ;
         for (size_t i = 0; i < initial_slabs; ++i) {
-            add_slab();
+            add_slab(initial_capacity >= SLAB_SZ);
         }
     }
 
     ~SlabPool() {
-        for (auto* slab : slabs_) {
+        for (size_t s = 0; s < slabs_.size(); ++s) {
+            Slab* slab = slabs_[s];
+            bool untouched = (bump_slab_ == static_cast<size_t>(-1) || s > bump_slab_);
+            if (std::is_trivially_destructible<T>::value || untouched) {
+                delete slab;
+                continue;
+            }
             for (size_t i = 0; i < SLAB_SZ; ++i) {
                 T* obj = reinterpret_cast<T*>(slab->storage + i * OBJECT_SIZE);
+                if (s == bump_slab_ && reinterpret_cast<char*>(obj) >= bump_) {
+                    break; // never handed out
+                }
                 bool in_free_list = false;
                 for (FreeNode* node = free_list_; node; node = node->next) {
                     if (to_free_node(obj) == node) {
@@ -141,28 +166,32 @@ public:
     SlabPool(const SlabPool&) = delete;
     SlabPool& operator=(const SlabPool&) = delete;
 
-    void add_slab() {
-        Slab* slab = new Slab();
+    void add_slab(bool huge_pages = true) {
+        Slab* slab = new Slab(huge_pages);
         slabs_.push_back(slab);
         total_capacity_ += SLAB_SZ;
-
-        for (size_t i = 0; i < SLAB_SZ; ++i) {
-            FreeNode* node = reinterpret_cast<FreeNode*>(slab->storage + i * OBJECT_SIZE);
-            node->next = free_list_;
-            free_list_ = node;
-        }
     }
 
     template<typename... Args>
     T* allocate(Args&&... args) {
-        if (LOB_UNLIKELY(!free_list_)) {
-            add_slab();
+        T* obj;
+        if (LOB_LIKELY(free_list_ != nullptr)) {
+            FreeNode* node = free_list_;
+            free_list_ = node->next;
+            obj = to_object(node);
+        } else {
+            if (LOB_UNLIKELY(bump_ == bump_end_)) {
+                if (bump_slab_ + 1 == slabs_.size()) {
+                    add_slab();
+                }
+                ++bump_slab_;
+                bump_ = slabs_[bump_slab_]->storage;
+                bump_end_ = bump_ + SLAB_BYTES;
+            }
+            obj = reinterpret_cast<T*>(bump_);
+            bump_ += OBJECT_SIZE;
         }
 
-        FreeNode* node = free_list_;
-        free_list_ = node->next;
-
-        T* obj = to_object(node);
         new (obj) T(std::forward<Args>(args)...);
         ++allocated_count_;
 
@@ -0,0 +1,84 @@
+#ifndef LOB_SNAPSHOT_H
+#define LOB_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "Types.h"
+
+/**
+ * Binary book snapshot (see BasicBook::save_snapshot). Layout, host byte order:
+ *
+ *   SnapshotHeader
+ *   for each queue: SnapshotLevel, then order_count SnapshotOrder in FIFO order
+ *
+ * Queues appear in list order: bid levels best first, ask levels best first,
+ * the four peg queues, buy stop triggers, sell stop triggers. A loader can
+ * therefore append each level at the tail of its list without searching.
+ */
+enum SnapshotQueue : std::uint8_t {
+    SNAP_BID_LEVEL,
+    SNAP_ASK_LEVEL,
+    SNAP_PEG_QUEUE,
+    SNAP_BUY_STOP,
+    SNAP_SELL_STOP
+};
+
+struct SnapshotHeader {
+    std::uint64_t magic;
+    std::uint32_t version;
+    PRICE last_trade_price;
+    std::uint64_t journal_position; /**< Journal records already reflected in the snapshot */
+    Timestamp time;                 /**< Book clock (get_time()) */
+    std::uint64_t level_count;      /**< SnapshotLevel records that follow */
+    std::uint64_t order_count;      /**< SnapshotOrder records that follow */
+    std::uint8_t stp_mode;
+    std::uint8_t auction_mode;
+    std::uint8_t reserved[6];
+};
+
+struct SnapshotLevel {
+    std::uint64_t order_count;
+    PRICE price;                    /**< Limit price, trigger price for stops, 0 for pegs */
+    SnapshotQueue queue;
+    std::uint8_t reserved[3];
+};
+
+struct SnapshotOrder {
+    ID order_id;
+    ID agent_id;
+    Volume initial_volume;
+    Volume remaining_volume;
+    Volume reserve_volume;
+    Volume display_volume;
+    Timestamp expire_time;
+    PRICE price;
+    PRICE trigger_price;
+    std::uint8_t side;              // OrderType
+    std::uint8_t hidden;
+    std::uint8_t peg_type;          // PegType
+    std::uint8_t status;            // OrderStatus
+    std::uint8_t reserved[4];
+};
+
+static_assert(sizeof(SnapshotHeader) == 56, "SnapshotHeader layout is part of the file format");
+static_assert(sizeof(SnapshotLevel) == 16, "SnapshotLevel layout is part of the file format");
+static_assert(sizeof(SnapshotOrder) == 72, "SnapshotOrder layout is part of the file format");
+static_assert(std::is_trivially_copyable<SnapshotOrder>::value, "SnapshotOrder is copied bytewise");
+
+constexpr std::uint64_t SNAPSHOT_MAGIC = 0x3150414E53424F4CULL; // "LOBSNAP1"
+constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+
+/**
+ * @brief Writes `size` bytes to `path` via a temporary file, fsync and rename,
+ * so a crash leaves either the old snapshot or the new one
+ */
+bool write_file_atomically(const char* path, const void* data, size_t size);
+
+/**
+ * @brief Reads a whole file into `out` (one read)
+ */
+bool read_file(const char* path, std::vector<unsigned char>& out);
+
+#endif // LOB_SNAPSHOT_H
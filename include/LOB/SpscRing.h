@@ -0,0 +1,121 @@
+#ifndef LOB_SPSC_RING_H
+#define LOB_SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include "Macros.h"
+
+/**
+ * SpscRing: bounded single-producer / single-consumer ring buffer.
+ *
+ * Storage is allocated once in the constructor (capacity rounded up to a
+ * power of two). Head and tail live on separate cache lines and each side
+ * keeps a cached copy of the other's index, so the shared lines are only
+ * touched when the cached view says the ring is full (producer) or empty
+ * (consumer). T must be trivially copyable.
+ */
+template<typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing slots are copied bytewise");
+
+    private:
+        const size_t mask;
+        std::unique_ptr<T[]> slots;
+
+        // Producer side
+        alignas(LOB_CACHE_LINE) std::atomic<size_t> tail;
+        size_t cached_head;
+
+        // Consumer side
+        alignas(LOB_CACHE_LINE) std::atomic<size_t> head;
+        size_t cached_tail;
+
+        static size_t round_up_pow2(size_t n) {
+            size_t capacity = 2;
+            while (capacity < n) capacity <<= 1;
+            return capacity;
+        }
+
+    public:
+        explicit SpscRing(size_t capacity)
+            : mask(round_up_pow2(capacity) - 1),
+              slots(new T[mask + 1]),
+              tail(0), cached_head(0),
+              head(0), cached_tail(0) {}
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        /** Producer: append one element, false if the ring is full */
+        bool try_push(const T& value) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            if (LOB_UNLIKELY(t - cached_head > mask)) {
+                cached_head = head.load(std::memory_order_acquire);
+                if (t - cached_head > mask) return false;
+            }
+            slots[t & mask] = value;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Producer: append one element, spinning while the ring is full */
+        void push(const T& value) {
+            unsigned spins = 0;
+            while (!try_push(value)) {
+                if (++spins < 64) {
+                    LOB_CPU_RELAX();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        /** Consumer: remove one element, false if the ring is empty */
+        bool try_pop(T& out) {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h == cached_tail) {
+                cached_tail = tail.load(std::memory_order_acquire);
+                if (h == cached_tail) return false;
+            }
+            out = slots[h & mask];
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Consumer: hand up to max_batch elements to fn in order and release
+         * their slots with a single store. If fn returns bool, false declines
+         * the element: it stays in the ring and the batch ends there.
+         * @return number of elements consumed
+         */
+        template<typename Fn>
+        size_t consume(Fn&& fn, size_t max_batch = static_cast<size_t>(-1)) {
+            size_t h = head.load(std::memory_order_relaxed);
+            cached_tail = tail.load(std::memory_order_acquire);
+            size_t available = cached_tail - h;
+            size_t n = available < max_batch ? available : max_batch;
+            for (size_t i = 0; i < n; ++i) {
+                if constexpr (std::is_same<std::invoke_result_t<Fn&, T&>, bool>::value) {
+                    if (!fn(slots[(h + i) & mask])) {
+                        n = i;
+                        break;
+                    }
+                } else {
+                    fn(slots[(h + i) & mask]);
+                }
+            }
+            if (n != 0) head.store(h + n, std::memory_order_release);
+            return n;
+        }
+
+        size_t capacity() const { return mask + 1; }
+        size_t size() const {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+        bool empty() const { return size() == 0; }
+};
+
+#endif // LOB_SPSC_RING_H
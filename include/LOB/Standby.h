@@ -0,0 +1,298 @@
+#ifndef LOB_STANDBY_H
+#define LOB_STANDBY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "Command.h"
+#include "EngineRunner.h"
+#include "Macros.h"
+
+/**
+ * Shared-memory command stream between a primary engine and a hot-standby
+ * follower process.
+ *
+ * The region is a POSIX shared memory object (shm_open, i.e. a file under
+ * /dev/shm) holding a StandbyRegionHeader and a power-of-two ring of
+ * Commands. The primary publishes every command before applying it and
+ * stamps a heartbeat; the follower applies the same commands to its own
+ * book and reports how far it got. Both sides only touch their own cache
+ * line of the header, through std::atomic_ref (lock-free atomics are
+ * address-free, so they work across processes).
+ *
+ * Lag is bounded by the ring: the primary never overwrites a command the
+ * follower has not applied, it spins instead. A follower that stops
+ * heartbeating for longer than the primary's timeout while the ring is full
+ * is dropped (STANDBY_DROPPED): publishing stops and the follower must not
+ * promote, it has to be rebuilt from a snapshot and the journal.
+ *
+ * When the primary's heartbeat stops for longer than the follower's timeout
+ * (while the primary is live: not closed cleanly nor paused), the follower promotes: it
+ * marks itself STANDBY_PROMOTED (which fences a primary that comes back,
+ * see StandbyPublisher::is_fenced) and applies what had been published at
+ * that point, so failover costs one ring drain. The primary checks the fence
+ * after each publish and must not apply a command once it sees it (the
+ * follower may or may not have taken that last one).
+ *
+ * A primary that stops on purpose without closing (EngineRunner::stop, or a
+ * full journal) marks itself STANDBY_PAUSED; the follower keeps following
+ * but does not promote until it goes live again and then falls silent.
+ */
+enum StandbyState : std::uint32_t {
+    STANDBY_NONE = 0,      // follower not attached yet
+    STANDBY_LIVE = 1,
+    STANDBY_CLOSED = 2,    // primary shut down cleanly
+    STANDBY_DROPPED = 3,   // primary gave up on a stalled follower
+    STANDBY_PROMOTED = 4,  // follower took over
+    STANDBY_PAUSED = 5     // primary stopped on purpose and may resume: do not promote
+};
+
+inline constexpr std::uint64_t STANDBY_MAGIC = 0x3142535F424F4CULL;   // "LOB_SB1"
+inline constexpr std::uint32_t STANDBY_VERSION = 3;
+
+struct StandbyRegionHeader {
+    std::uint64_t magic;                 // written last by the primary
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t capacity;              // ring slots, power of two
+
+    // Primary
+    alignas(LOB_CACHE_LINE) std::uint64_t published;
+    std::uint64_t primary_heartbeat_ns;
+    std::uint32_t primary_state;
+
+    // Follower
+    alignas(LOB_CACHE_LINE) std::uint64_t applied;
+    std::uint64_t follower_heartbeat_ns;
+
+    // Written on attach and promotion only: the primary reads it per publish
+    alignas(LOB_CACHE_LINE) std::uint32_t follower_state;
+};
+
+static_assert(sizeof(StandbyRegionHeader) == 4 * LOB_CACHE_LINE, "header is four cache lines");
+static_assert(sizeof(StandbyRegionHeader) % alignof(Command) == 0, "ring follows the header");
+
+/** @brief CLOCK_MONOTONIC in ns; comparable between processes on one host */
+inline std::uint64_t standby_clock_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * StandbyPublisher: primary side of the shared-memory command stream.
+ *
+ * Creates (or recreates) the shared memory object `name` (e.g.
+ * "/lob_standby"); the destructor marks the stream closed and unlinks the
+ * name. Single producer: publish() and heartbeat() are called by the
+ * matching thread, see EngineRunner::attach_standby.
+ */
+class StandbyPublisher {
+    private:
+        int fd;
+        void* base;
+        size_t map_bytes;
+        char name[64];
+        StandbyRegionHeader* header;
+        Command* slots;
+        std::uint64_t mask;
+        std::uint64_t published;
+        std::uint64_t cached_applied;
+        std::uint64_t follower_timeout_ns;
+        bool replicating;
+
+        bool create(const char* name, size_t capacity);
+        bool wait_for_space();
+
+    public:
+        /**
+         * @param capacity ring slots (rounded up to a power of two): the
+         *        maximum number of commands the follower may lag behind
+         * @param follower_timeout how long a full ring waits on a follower
+         *        that has stopped heartbeating before dropping it
+         */
+        explicit StandbyPublisher(
+            const char* name,
+            size_t capacity = 65536,
+            std::chrono::milliseconds follower_timeout = std::chrono::milliseconds(500)
+        );
+        ~StandbyPublisher();
+
+        StandbyPublisher(const StandbyPublisher&) = delete;
+        StandbyPublisher& operator=(const StandbyPublisher&) = delete;
+
+        bool is_open() const { return header != nullptr; }
+
+        /**
+         * @brief Copies one command into the ring; spins while the follower
+         * is a full ring behind
+         * @return false once the stream is closed, the follower has been
+         *         dropped, or it has promoted (is_fenced(): do not apply the
+         *         command)
+         */
+        bool publish(const Command& command) {
+            if (LOB_UNLIKELY(!replicating || published - cached_applied > mask)) {
+                if (!wait_for_space()) return false;
+            }
+            slots[published & mask] = command;
+            // Pairs with promote(): either the follower's drain includes this
+            // command or this load sees the fence
+            std::atomic_ref<std::uint64_t>(header->published).store(++published, std::memory_order_seq_cst);
+            if (LOB_UNLIKELY(is_fenced())) {
+                replicating = false;
+                return false;
+            }
+            return true;
+        }
+
+        /** @brief Stamps the primary's heartbeat (once per batch / idle round) */
+        void heartbeat() {
+            std::atomic_ref<std::uint64_t>(header->primary_heartbeat_ns)
+                .store(standby_clock_ns(), std::memory_order_release);
+        }
+
+        /** @brief Marks the stream closed: the follower will not promote */
+        void close();
+
+        /**
+         * @brief Marks the primary stopped but not closed (STANDBY_PAUSED): the
+         * follower does not promote on the silent heartbeat. EngineRunner
+         * pauses when its thread exits without being fenced.
+         */
+        void pause();
+
+        /** @brief Stamps the heartbeat and goes live again after pause() */
+        void resume();
+
+        /** @brief True if the follower has promoted itself; this primary must stop accepting orders */
+        bool is_fenced() const {
+            return std::atomic_ref<std::uint32_t>(header->follower_state).load(std::memory_order_seq_cst)
+                == STANDBY_PROMOTED;
+        }
+
+        bool is_follower_attached() const {
+            return std::atomic_ref<std::uint32_t>(header->follower_state).load(std::memory_order_acquire)
+                != STANDBY_NONE;
+        }
+
+        /** @brief False once the stream is closed, the follower dropped or fenced */
+        bool is_replicating() const { return replicating; }
+
+        std::uint64_t get_published() const { return published; }
+        std::uint64_t get_applied() const {
+            return std::atomic_ref<std::uint64_t>(header->applied).load(std::memory_order_acquire);
+        }
+        size_t get_capacity() const { return static_cast<size_t>(mask + 1); }
+};
+
+/**
+ * StandbyFollower: hot-standby side; attaches to the region created by a
+ * StandbyPublisher and replays its commands into a book of its own.
+ *
+ * One follower per region. poll() and promote() are called from a single
+ * thread (typically follow()).
+ */
+class StandbyFollower {
+    private:
+        int fd;
+        void* base;
+        size_t map_bytes;
+        StandbyRegionHeader* header;
+        const Command* slots;
+        std::uint64_t mask;
+        std::uint64_t applied;
+
+        bool attach(const char* name);
+
+    public:
+        explicit StandbyFollower(const char* name);
+        ~StandbyFollower();
+
+        StandbyFollower(const StandbyFollower&) = delete;
+        StandbyFollower& operator=(const StandbyFollower&) = delete;
+
+        /** False if the region does not exist, is invalid, or already has a follower */
+        bool is_open() const { return header != nullptr; }
+
+        /**
+         * @brief Applies up to max_batch published commands and stamps the
+         * follower heartbeat (also when there is nothing to apply)
+         * @return number of commands applied
+         */
+        template<typename BookType>
+        size_t poll(BookType& book, size_t max_batch = 256) {
+            std::uint64_t available =
+                std::atomic_ref<std::uint64_t>(header->published).load(std::memory_order_acquire) - applied;
+            size_t n = available < max_batch ? static_cast<size_t>(available) : max_batch;
+            for (size_t i = 0; i < n; ++i) {
+                apply_command(book, slots[(applied + i) & mask]);
+            }
+            if (n != 0) {
+                applied += n;
+                std::atomic_ref<std::uint64_t>(header->applied).store(applied, std::memory_order_release);
+            }
+            std::atomic_ref<std::uint64_t>(header->follower_heartbeat_ns)
+                .store(standby_clock_ns(), std::memory_order_release);
+            return n;
+        }
+
+        /** @brief True if the primary is live but silent for longer than timeout */
+        bool primary_failed(std::chrono::nanoseconds timeout) const;
+
+        std::uint32_t get_primary_state() const {
+            return std::atomic_ref<std::uint32_t>(header->primary_state).load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Takes over: fences the primary, then applies what it had
+         * published by then (a primary still running cannot extend the drain)
+         * @return false (and nothing applied) if the primary had dropped this
+         *         follower, whose book is then incomplete
+         */
+        template<typename BookType>
+        bool promote(BookType& book) {
+            if (get_primary_state() == STANDBY_DROPPED) return false;
+            std::atomic_ref<std::uint32_t>(header->follower_state)
+                .store(STANDBY_PROMOTED, std::memory_order_seq_cst);
+            std::uint64_t end = std::atomic_ref<std::uint64_t>(header->published).load(std::memory_order_seq_cst);
+            while (applied < end) {
+                std::uint64_t left = end - applied;
+                poll(book, left < 256 ? static_cast<size_t>(left) : 256);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Follows until the primary fails (promotes, returns true) or
+         * closes / drops this follower (returns false after catching up)
+         * @param stop optional flag that ends the loop early (returns false)
+         */
+        template<typename BookType>
+        bool follow(BookType& book, std::chrono::nanoseconds timeout,
+                    WaitStrategy strategy = WAIT_BACKOFF, const std::atomic<bool>* stop = nullptr) {
+            unsigned idle_rounds = 0;
+            while (!stop || !stop->load(std::memory_order_relaxed)) {
+                if (poll(book) != 0) {
+                    idle_rounds = 0;
+                    continue;
+                }
+                std::uint32_t state = get_primary_state();
+                if (state == STANDBY_CLOSED || state == STANDBY_DROPPED) {
+                    while (poll(book) != 0) {}
+                    return false;
+                }
+                if (primary_failed(timeout)) {
+                    return promote(book);
+                }
+                idle_wait(strategy, idle_rounds++);
+            }
+            return false;
+        }
+
+        std::uint64_t get_applied() const { return applied; }
+        /** Commands published but not applied yet */
+        std::uint64_t get_lag() const {
+            return std::atomic_ref<std::uint64_t>(header->published).load(std::memory_order_acquire) - applied;
+        }
+};
+
+#endif // LOB_STANDBY_H
@@ -0,0 +1,46 @@
+#ifndef LOB_STATE_HASH_H
+#define LOB_STATE_HASH_H
+
+#include <cstdint>
+#include "Level.h"
+
+/**
+ * Order-sensitive 64-bit hash of resting book state, shared by Book and its
+ * replicas: bids best-first, a side separator, then asks best-first; within a
+ * level every order in FIFO order (id, agent, remaining, reserve, hidden).
+ * Equal hashes mean equal levels, volumes and queue positions.
+ */
+inline std::uint64_t hash_mix(std::uint64_t h, std::uint64_t value) {
+    // splitmix64 finalizer over the running state
+    h ^= value + UINT64_C(0x9e3779b97f4a7c15) + (h << 6) + (h >> 2);
+    h ^= h >> 30;
+    h *= UINT64_C(0xbf58476d1ce4e5b9);
+    h ^= h >> 27;
+    h *= UINT64_C(0x94d049bb133111eb);
+    return h ^ (h >> 31);
+}
+
+inline std::uint64_t hash_level(std::uint64_t h, const Level& level) {
+    h = hash_mix(h, level.get_price());
+    for (const Order* order = level.get_head(); order; order = order->get_next_order()) {
+        h = hash_mix(h, order->get_order_id());
+        h = hash_mix(h, order->get_agent_id());
+        h = hash_mix(h, order->get_remaining_volume());
+        h = hash_mix(h, order->get_reserve_volume());
+        h = hash_mix(h, order->is_hidden());
+    }
+    return h;
+}
+
+constexpr std::uint64_t STATE_HASH_SEED = UINT64_C(0x4c4f42);          // "LOB"
+constexpr std::uint64_t STATE_HASH_SIDE_SEPARATOR = UINT64_C(0x5349444553455021);
+
+inline std::uint64_t hash_book(const Level* bids_head, const Level* asks_head) {
+    std::uint64_t h = STATE_HASH_SEED;
+    for (const Level* l = bids_head; l; l = l->get_next_level()) h = hash_level(h, *l);
+    h = hash_mix(h, STATE_HASH_SIDE_SEPARATOR);
+    for (const Level* l = asks_head; l; l = l->get_next_level()) h = hash_level(h, *l);
+    return h;
+}
+
+#endif // LOB_STATE_HASH_H
@@ -0,0 +1,177 @@
+#ifndef LOB_TIMING_WHEEL_H
+#define LOB_TIMING_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Order.h"
+#include "Macros.h"
+
+/**
+ * TimingWheel: hierarchical timing wheel for good-till-time order expiry.
+ *
+ * - 11 levels of 64 slots cover the full 64-bit Timestamp range
+ * - A timer due at `e` sits at the level of the highest 6-bit digit in which
+ *   `e` differs from the wheel's current time, in the slot of that digit
+ * - Slots are intrusive doubly-linked lists through Order's timer links, so
+ *   schedule and cancel are O(1) and never allocate
+ * - Per-level occupancy bitmaps let advance() jump straight to the next
+ *   non-empty slot, so a large time step costs O(expired + cascaded), not
+ *   O(elapsed ticks)
+ *
+ * Invariant: every scheduled timer at (level L, slot s) has the same digits
+ * as now() above L, and s is greater than now()'s digit at L.
+ */
+class TimingWheel {
+private:
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr unsigned SLOTS = 1u << SLOT_BITS;
+    static constexpr unsigned LEVELS = (64 + SLOT_BITS - 1) / SLOT_BITS;
+
+    Order* slots_[LEVELS][SLOTS];
+    std::uint64_t occupied_[LEVELS];
+    Timestamp now_;
+    size_t size_;
+
+    static unsigned highest_bit(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(x));
+#else
+        unsigned bit = 0;
+        while (x >>= 1) ++bit;
+        return bit;
+#endif
+    }
+
+    static unsigned lowest_bit(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+        unsigned bit = 0;
+        while (!(x & 1)) { x >>= 1; ++bit; }
+        return bit;
+#endif
+    }
+
+    // Requires expire_time > now_
+    void locate(Timestamp expire_time, unsigned& level, unsigned& slot) const {
+        level = highest_bit(expire_time ^ now_) / SLOT_BITS;
+        slot = static_cast<unsigned>(expire_time >> (level * SLOT_BITS)) & (SLOTS - 1);
+    }
+
+    void link(Order* order) {
+        unsigned level, slot;
+        locate(order->get_expire_time(), level, slot);
+        Order* head = slots_[level][slot];
+        order->set_timer_prev(nullptr);
+        order->set_timer_next(head);
+        if (head) head->set_timer_prev(order);
+        slots_[level][slot] = order;
+        occupied_[level] |= std::uint64_t{1} << slot;
+    }
+
+public:
+    explicit TimingWheel(Timestamp start = 0)
+        : now_(start),
+          size_(0) {
+        for (unsigned l = 0; l < LEVELS; ++l) {
+            occupied_[l] = 0;
+            for (unsigned s = 0; s < SLOTS; ++s) {
+                slots_[l][s] = nullptr;
+            }
+        }
+    }
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    /**
+     * @brief Schedules an order's expiry (order must not already be scheduled)
+     * @param order order with get_expire_time() > now()
+     */
+    void schedule(Order* order) {
+        link(order);
+        ++size_;
+    }
+
+    /**
+     * @brief Removes a scheduled order from the wheel in O(1)
+     */
+    void cancel(Order* order) {
+        Order* prev = order->get_timer_prev();
+        Order* next = order->get_timer_next();
+        if (next) next->set_timer_prev(prev);
+        if (prev) {
+            prev->set_timer_next(next);
+        } else {
+            unsigned level, slot;
+            locate(order->get_expire_time(), level, slot);
+            slots_[level][slot] = next;
+            if (!next) occupied_[level] &= ~(std::uint64_t{1} << slot);
+        }
+        order->set_timer_prev(nullptr);
+        order->set_timer_next(nullptr);
+        --size_;
+    }
+
+    /**
+     * @brief Moves time forward to `now`, calling on_expire(Order*) for every
+     * order with expire_time <= now. Expired orders are already unlinked from
+     * the wheel when the callback runs.
+     */
+    template<typename F>
+    void advance(Timestamp now, F&& on_expire) {
+        if (now <= now_) return;
+
+        while (size_ != 0) {
+            // The lowest level with a pending slot holds the earliest timers
+            unsigned level = LEVELS;
+            unsigned slot = 0;
+            for (unsigned l = 0; l < LEVELS; ++l) {
+                unsigned shift = l * SLOT_BITS;
+                unsigned digit = static_cast<unsigned>(now_ >> shift) & (SLOTS - 1);
+                std::uint64_t ahead = (digit == SLOTS - 1)
+                                      ? 0
+                                      : occupied_[l] & (~std::uint64_t{0} << (digit + 1));
+                if (ahead) {
+                    level = l;
+                    slot = lowest_bit(ahead);
+                    break;
+                }
+            }
+            if (level == LEVELS) break;
+
+            unsigned shift = level * SLOT_BITS;
+            unsigned span_bits = shift + SLOT_BITS;
+            Timestamp base = (span_bits >= 64) ? 0 : (now_ & ~((Timestamp{1} << span_bits) - 1));
+            Timestamp slot_start = base + (static_cast<Timestamp>(slot) << shift);
+            if (slot_start > now) break;
+
+            now_ = slot_start;
+            Order* order = slots_[level][slot];
+            slots_[level][slot] = nullptr;
+            occupied_[level] &= ~(std::uint64_t{1} << slot);
+
+            // Expire what is due, cascade the rest into lower levels
+            while (order) {
+                Order* next = order->get_timer_next();
+                order->set_timer_prev(nullptr);
+                order->set_timer_next(nullptr);
+                if (order->get_expire_time() <= now_) {
+                    --size_;
+                    on_expire(order);
+                } else {
+                    link(order);
+                }
+                order = next;
+            }
+        }
+
+        now_ = now;
+    }
+
+    Timestamp now() const { return now_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+};
+
+#endif // LOB_TIMING_WHEEL_H
@@ -0,0 +1,31 @@
+#ifndef LOB_TOP_OF_BOOK_H
+#define LOB_TOP_OF_BOOK_H
+
+#include <cstdint>
+#include "Types.h"
+#include "SeqLock.h"
+
+/**
+ * TopOfBook: best displayed bid / ask with displayed size and order count,
+ * plus the last trade price; hidden orders are left out. A missing side has
+ * price 0. 48 bytes, so together with
+ * the seqlock sequence it occupies a single cache line.
+ */
+struct TopOfBook {
+    Volume bid_volume;
+    Volume ask_volume;
+    Length bid_orders;
+    Length ask_orders;
+    PRICE bid_price;
+    PRICE ask_price;
+    PRICE last_trade_price;
+    std::uint32_t reserved;
+
+    bool operator==(const TopOfBook& other) const = default;
+};
+
+using TopOfBookPublisher = SeqLock<TopOfBook>;
+
+static_assert(sizeof(TopOfBookPublisher) == LOB_CACHE_LINE, "top of book must fit one cache line");
+
+#endif // LOB_TOP_OF_BOOK_H
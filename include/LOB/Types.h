@@ -7,8 +7,48 @@ using ID = std::uint64_t;
 using PRICE = std::uint32_t;
 using Volume = std::uint64_t;
 using Length = std::uint64_t;
+using Timestamp = std::uint64_t;
 
 enum OrderType { BUY, SELL };
-enum OrderStatus { ACTIVE, FULFILLED, DELETED };
+enum OrderStatus { ACTIVE, FULFILLED, DELETED, PENDING }; // PENDING: stop awaiting its trigger
+
+/**
+ * Why volume left the book without trading (see EventSink on_cancel).
+ */
+enum CancelReason { CANCEL_USER, CANCEL_SELF_TRADE, CANCEL_EXPIRED, CANCEL_UNFILLED };
+
+/**
+ * Why an order was refused before entering the book (see EventSink on_reject).
+ * - REJECT_INVALID:     zero price or volume, or no peg reference
+ * - REJECT_EXPIRED:     good-till-time already in the past
+ * - REJECT_WOULD_CROSS: post-only order that would take liquidity
+ */
+enum RejectReason { REJECT_INVALID, REJECT_EXPIRED, REJECT_WOULD_CROSS };
+
+/**
+ * Peg reference of a pegged order.
+ * - PEG_NONE:     plain limit order
+ * - PEG_PRIMARY:  same-side best price (buys track best bid, sells best ask)
+ * - PEG_MIDPOINT: midpoint of best bid and ask (buys round down, sells up)
+ */
+enum PegType { PEG_NONE, PEG_PRIMARY, PEG_MIDPOINT };
+
+/**
+ * Handling of a post-only order that would take liquidity on arrival.
+ * - POST_ONLY_REJECT: reject it
+ * - POST_ONLY_SLIDE:  reprice it one tick off the opposite best price
+ */
+enum PostOnlyMode { POST_ONLY_REJECT, POST_ONLY_SLIDE };
+
+/**
+ * Self-trade prevention mode, applied when an incoming order would match a
+ * resting order with the same agent_id.
+ * - STP_NONE:          self-matches trade like any other match
+ * - STP_CANCEL_NEWEST: cancel the remainder of the incoming order
+ * - STP_CANCEL_OLDEST: cancel the resting order and keep matching
+ * - STP_CANCEL_BOTH:   cancel both orders
+ * - STP_DECREMENT:     reduce both by the smaller quantity without a trade
+ */
+enum StpMode { STP_NONE, STP_CANCEL_NEWEST, STP_CANCEL_OLDEST, STP_CANCEL_BOTH, STP_DECREMENT };
 
 #endif // LOB_TYPES_H
\ No newline at end of file
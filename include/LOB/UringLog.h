@@ -0,0 +1,273 @@
+#ifndef LOB_URING_LOG_H
+#define LOB_URING_LOG_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "Command.h"
+#include "ExecutionReport.h"
+#include "Journal.h"
+#include "Macros.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * UringLog: append-only file writer on io_uring (raw syscalls, no liburing).
+ *
+ * Records are copied into one of `segment_count` registered buffers. When a
+ * segment is full it is posted as a single IORING_OP_WRITE_FIXED at the next
+ * file offset (one io_uring_enter per segment, so the syscall is amortized
+ * over every record in it) and filling moves on to the next free segment.
+ * Completions are reaped by poll(), which only reads the completion ring and
+ * enters the kernel only to resubmit the tail of a short write at the offset
+ * it reached (a write that fails or makes no progress sets get_error()).
+ * sync() posts a drained fdatasync behind every write already posted and
+ * get_durable_bytes() advances when it completes (never past a failed write).
+ *
+ * Nothing on the append path waits for the disk: if every segment is still in
+ * flight, append() returns false and the caller decides (retry after poll(),
+ * or shed load). drain() is the only blocking call and is meant for shutdown.
+ *
+ * Single-threaded: the thread that appends also polls, flushes and syncs,
+ * and must drain() before it exits (requests belong to the submitting task).
+ * is_open() is false if io_uring is unavailable (old kernel, seccomp, or
+ * io_uring_disabled); falls back to unregistered buffers/files when
+ * registration is refused.
+ */
+class UringLog {
+    private:
+        struct Segment {
+            unsigned char* data;
+            size_t used;
+            size_t written;           // bytes completed (short writes are resubmitted)
+            std::uint64_t offset;     // file offset of data[0]
+            bool in_flight;
+        };
+
+        int fd;
+        int ring_fd;
+        bool fixed_buffers;
+        bool fixed_file;
+
+        // Mapped rings
+        void* sq_ring;
+        size_t sq_ring_bytes;
+        void* cq_ring;
+        size_t cq_ring_bytes;
+        io_uring_sqe* sqes;
+        size_t sqes_bytes;
+        unsigned* sq_tail;
+        unsigned* sq_mask;
+        unsigned* sq_array;
+        unsigned* cq_head;
+        unsigned* cq_tail;
+        unsigned* cq_mask;
+        io_uring_cqe* cqes;
+
+        unsigned char* buffers;
+        size_t buffers_bytes;
+        Segment* segments;
+        unsigned segment_count;
+        size_t segment_bytes;
+
+        // Segment being filled; limit 0 while every segment is in flight
+        unsigned current;
+        unsigned char* cur_data;
+        size_t cur_used;
+        size_t cur_limit;
+
+        std::uint64_t file_offset;      // next write offset (bytes posted)
+        std::uint64_t appended_bytes;
+        std::uint64_t completed_bytes;
+        std::uint64_t durable_bytes;
+        std::uint64_t sync_offset;
+        std::uint64_t lost_offset;      // first byte a failed write left out (~0 if none)
+        bool sync_in_flight;
+        unsigned in_flight;
+        int error;
+
+        bool setup(unsigned entries);
+        void teardown();
+        io_uring_sqe* next_sqe();
+        bool enter(unsigned to_submit, unsigned min_complete);
+        bool post_current();
+        bool post_write(unsigned index);
+        std::uint64_t durable_limit(std::uint64_t offset) const;
+        bool advance_segment();
+        bool append_slow(const void* data, size_t size);
+        bool reserve_slow(size_t size);
+
+    public:
+        /**
+         * @param path file to create (truncated)
+         * @param segment_bytes size of each registered buffer (one write each)
+         * @param segment_count buffers in rotation (writes in flight at once)
+         */
+        explicit UringLog(const char* path, size_t segment_bytes = 1 << 16, unsigned segment_count = 8);
+        ~UringLog();
+
+        UringLog(const UringLog&) = delete;
+        UringLog& operator=(const UringLog&) = delete;
+
+        bool is_open() const { return ring_fd >= 0; }
+
+        /**
+         * @brief Copies `size` bytes into the current segment (size <= segment_bytes)
+         * Posts the segment when it is full; never waits for the disk.
+         * @return false if every segment is in flight (nothing was copied)
+         */
+        bool append(const void* data, size_t size) {
+            if (LOB_LIKELY(cur_used + size <= cur_limit)) {
+                std::memcpy(cur_data + cur_used, data, size);
+                cur_used += size;
+                appended_bytes += size;
+                return true;
+            }
+            return append_slow(data, size);
+        }
+
+        template<typename Record>
+        bool append(const Record& record) {
+            static_assert(std::is_trivially_copyable<Record>::value, "records are copied bytewise");
+            return append(&record, sizeof(Record));
+        }
+
+        /**
+         * @brief Makes room for `size` bytes in the current segment without
+         * copying, so the next append() of that size cannot fail
+         * Posts the segment when it is full; never waits for the disk.
+         * @return false if every segment is in flight
+         */
+        bool reserve(size_t size) {
+            if (LOB_LIKELY(cur_used + size <= cur_limit)) return true;
+            return reserve_slow(size);
+        }
+
+        /** @brief Posts the partly filled segment, if any (e.g. on idle) */
+        bool flush();
+
+        /**
+         * @brief Posts an fdatasync ordered after every write posted so far
+         * @return false if a sync is already in flight
+         */
+        bool sync();
+
+        /**
+         * @brief Reaps completions; returns how many. Enters the kernel only
+         * to resubmit the tail of a short write at its advanced offset
+         */
+        size_t poll();
+
+        /** @brief Flushes, syncs and waits for every completion (blocking) */
+        void drain();
+
+        std::uint64_t get_appended_bytes() const { return appended_bytes; }
+        std::uint64_t get_posted_bytes() const { return file_offset; }
+        std::uint64_t get_completed_bytes() const { return completed_bytes; }
+        std::uint64_t get_durable_bytes() const { return durable_bytes; }
+        unsigned get_in_flight() const { return in_flight; }
+        /** First errno reported by a completion (0 if none) */
+        int get_error() const { return error; }
+};
+
+/**
+ * UringJournal: Journal file format (JournalHeader + JournalRecord slots,
+ * readable with read_journal) written through a UringLog instead of a mapping.
+ * The header's capacity is 0: the file grows as segments are written.
+ */
+class UringJournal {
+    private:
+        UringLog log;
+        std::uint64_t index;
+        bool header_written;
+
+    public:
+        explicit UringJournal(const char* path, size_t segment_bytes = 1 << 16, unsigned segment_count = 8);
+
+        /** False if io_uring is unavailable or a segment cannot hold a record */
+        bool is_open() const { return log.is_open() && header_written; }
+
+        /** @return false if every segment is in flight (see UringLog::reserve) */
+        bool reserve() { return log.reserve(sizeof(JournalRecord)); }
+
+        /** @return false if every segment is in flight (see UringLog::append) */
+        bool append(const Command& command) {
+            JournalRecord record;
+            record.command = command;
+            record.index = index + 1;
+            if (LOB_UNLIKELY(!log.append(record))) return false;
+            ++index;
+            return true;
+        }
+
+        std::uint64_t get_appended() const { return index; }
+        UringLog& get_log() { return log; }
+};
+
+/** First 64 bytes of an event log file; ExecutionReport records follow */
+struct EventLogHeader {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t reserved[6];
+};
+
+static_assert(sizeof(EventLogHeader) == 64, "EventLogHeader is one cache line");
+
+constexpr std::uint64_t EVENT_LOG_MAGIC = 0x31474C5645424F4CULL; // "LOBEVLG1"
+constexpr std::uint32_t EVENT_LOG_VERSION = 1;
+
+/**
+ * UringEventLog: the egress side of persistence. Writes ExecutionReports
+ * (EventLogHeader, then one 64-byte record per report, readable with
+ * read_event_log) through a UringLog.
+ *
+ * Meant for the thread that consumes a runner's ExecutionRing: consume()
+ * moves reports from the ring into segments and reaps completions, so the
+ * matching thread never waits on this disk either. All calls belong to that
+ * one thread, which must drain() the log before it exits.
+ */
+class UringEventLog {
+    private:
+        UringLog log;
+        std::uint64_t appended;
+        bool header_written;
+
+    public:
+        explicit UringEventLog(const char* path, size_t segment_bytes = 1 << 16, unsigned segment_count = 8);
+
+        /** False if io_uring is unavailable or a segment cannot hold a report */
+        bool is_open() const { return log.is_open() && header_written; }
+
+        /** @return false if every segment is in flight (see UringLog::append) */
+        bool append(const ExecutionReport& report) {
+            if (LOB_UNLIKELY(!log.append(report))) return false;
+            ++appended;
+            return true;
+        }
+
+        /**
+         * @brief Moves up to max_batch reports from `ring` into the log, then
+         * reaps completions. Stops early, leaving the rest in the ring, while
+         * every segment is in flight.
+         * @return number of reports taken from the ring
+         */
+        size_t consume(ExecutionRing& ring, size_t max_batch = 256) {
+            size_t n = ring.consume([this](const ExecutionReport& report) { return append(report); }, max_batch);
+            log.poll();
+            return n;
+        }
+
+        std::uint64_t get_appended() const { return appended; }
+        UringLog& get_log() { return log; }
+};
+
+/**
+ * @brief Reads every complete report of an event log file into `out`
+ * @return false if the file is missing or not an event log
+ */
+bool read_event_log(const char* path, std::vector<ExecutionReport>& out);
+
+#endif // LOB_URING_LOG_H
@@ -1,3 +1,46 @@
+#include <iostream>
+#include "LOB/EngineRunner.h"
+
+// Minimal engine wiring: a gateway (this thread) feeds the matching thread
+// through the ingress ring and prints the execution reports it gets back.
 int main() {
+    CommandRing ingress(1024);
+    ExecutionRing egress(1024);
+    EngineRunner runner(ingress, egress);
+    runner.start();
+
+    Command sell{};
+    sell.type = CMD_NEW;
+    sell.order_id = 1;
+    sell.agent_id = 1;
+    sell.side = SELL;
+    sell.price = 100;
+    sell.volume = 10;
+    ingress.push(sell);
+
+    Command buy = sell;
+    buy.order_id = 2;
+    buy.agent_id = 2;
+    buy.side = BUY;
+    buy.volume = 4;
+    ingress.push(buy);
+
+    Command amend{};
+    amend.type = CMD_AMEND;
+    amend.order_id = 1;
+    amend.price = 100;
+    amend.volume = 3;
+    ingress.push(amend);
+
+    runner.stop();
+
+    static const char* names[] = {"ACCEPTED", "PARTIAL_FILL", "FILL", "CANCELLED", "REJECTED"};
+    egress.consume([](const ExecutionReport& r) {
+        std::cout << r.sequence << ' ' << names[r.exec_type]
+                  << " order=" << r.order_id
+                  << " price=" << r.price
+                  << " last=" << r.last_volume
+                  << " leaves=" << r.leaves_volume << std::endl;
+    });
     return 0;
-}
\ No newline at end of file
+}
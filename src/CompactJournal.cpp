@@ -0,0 +1,122 @@
+#include "LOB/CompactJournal.h"
+#include "LOB/Snapshot.h"
+
+CompactJournalWriter::CompactJournalWriter(const char* path, size_t block_bytes)
+    : file(std::fopen(path, "wb")),
+      block(sizeof(CompactBlockHeader) + (block_bytes > COMPACT_MAX_RECORD_BYTES ? block_bytes : COMPACT_MAX_RECORD_BYTES)),
+      block_bytes(block.size() - sizeof(CompactBlockHeader)),
+      block_used(0),
+      block_records(0),
+      offset(0),
+      records(0) {
+    if (!file) return;
+    CompactFileHeader header{COMPACT_JOURNAL_MAGIC, COMPACT_JOURNAL_VERSION,
+                             static_cast<std::uint32_t>(this->block_bytes)};
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::fclose(file);
+        file = nullptr;
+        return;
+    }
+    offset = sizeof(header);
+}
+
+CompactJournalWriter::~CompactJournalWriter() {
+    close();
+}
+
+bool CompactJournalWriter::write_block() {
+    if (!file) return false;
+    if (block_records == 0) return true;
+
+    CompactBlockHeader header{static_cast<std::uint32_t>(block_used), block_records};
+    std::memcpy(block.data(), &header, sizeof(header));
+    size_t size = sizeof(header) + block_used;
+    if (std::fwrite(block.data(), 1, size, file) != size) return false;
+
+    index.push_back(CompactIndexEntry{offset, records - block_records});
+    offset += size;
+    block_used = 0;
+    block_records = 0;
+    state = CompactDeltaState{};
+    return true;
+}
+
+bool CompactJournalWriter::close() {
+    if (!file) return false;
+    bool ok = write_block();
+
+    CompactFooter footer{offset, index.size(), records, COMPACT_JOURNAL_MAGIC};
+    size_t index_bytes = index.size() * sizeof(CompactIndexEntry);
+    ok = ok && (index.empty() || std::fwrite(index.data(), 1, index_bytes, file) == index_bytes);
+    ok = ok && std::fwrite(&footer, sizeof(footer), 1, file) == 1;
+    offset += index_bytes + sizeof(footer);
+    ok = (std::fclose(file) == 0) && ok;
+    file = nullptr;
+    return ok;
+}
+
+CompactJournalReader::CompactJournalReader(const char* path)
+    : records(0),
+      valid(false) {
+    if (!read_file(path, bytes) || bytes.size() < sizeof(CompactFileHeader)) return;
+
+    CompactFileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != COMPACT_JOURNAL_MAGIC || header.version != COMPACT_JOURNAL_VERSION) return;
+
+    valid = load_index() || scan_blocks();
+}
+
+bool CompactJournalReader::load_index() {
+    if (bytes.size() < sizeof(CompactFileHeader) + sizeof(CompactFooter)) return false;
+
+    CompactFooter footer;
+    std::memcpy(&footer, bytes.data() + bytes.size() - sizeof(footer), sizeof(footer));
+    if (footer.magic != COMPACT_JOURNAL_MAGIC) return false;
+    // Bound each term before summing so a corrupt footer cannot wrap the total
+    size_t body = bytes.size() - sizeof(footer);
+    if (footer.block_count > body / sizeof(CompactIndexEntry) || footer.index_offset > body
+        || footer.index_offset + footer.block_count * sizeof(CompactIndexEntry) != body) {
+        return false;
+    }
+    index.resize(footer.block_count);
+    if (footer.block_count != 0) {
+        std::memcpy(index.data(), bytes.data() + footer.index_offset, footer.block_count * sizeof(CompactIndexEntry));
+    }
+    // Every indexed block, payload included, must lie before the index, and
+    // the blocks' record counts must chain up to the footer's record count
+    std::uint64_t next_record = 0;
+    for (const CompactIndexEntry& entry : index) {
+        if (entry.offset < sizeof(CompactFileHeader) || entry.offset > footer.index_offset
+            || footer.index_offset - entry.offset < sizeof(CompactBlockHeader)
+            || entry.first_record != next_record) {
+            return false;
+        }
+        CompactBlockHeader header;
+        std::memcpy(&header, bytes.data() + entry.offset, sizeof(header));
+        if (header.payload_bytes > footer.index_offset - entry.offset - sizeof(header)) return false;
+        next_record += header.record_count;
+    }
+    if (next_record != footer.record_count) return false;
+    records = footer.record_count;
+    return true;
+}
+
+// No footer: rebuild the index from the block headers, dropping a torn last block
+bool CompactJournalReader::scan_blocks() {
+    index.clear();
+    records = 0;
+    size_t offset = sizeof(CompactFileHeader);
+    while (offset + sizeof(CompactBlockHeader) <= bytes.size()) {
+        CompactBlockHeader header;
+        std::memcpy(&header, bytes.data() + offset, sizeof(header));
+        if (header.record_count == 0
+            || offset + sizeof(header) + header.payload_bytes > bytes.size()) {
+            break;
+        }
+        index.push_back(CompactIndexEntry{offset, records});
+        records += header.record_count;
+        offset += sizeof(header) + header.payload_bytes;
+    }
+    return true;
+}
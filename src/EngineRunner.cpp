@@ -0,0 +1,186 @@
+#include <chrono>
+#include "LOB/EngineRunner.h"
+#include "LOB/Journal.h"
+#include "LOB/Standby.h"
+#include "LOB/UringLog.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+void idle_wait(WaitStrategy strategy, unsigned idle_rounds) {
+    if (strategy == WAIT_BUSY_SPIN || idle_rounds < 64) {
+        LOB_CPU_RELAX();
+    } else if (idle_rounds < 1024) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+bool pin_current_thread(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+EngineRunner::EngineRunner(
+    CommandRing& ingress,
+    ExecutionRing& egress,
+    int cpu,
+    WaitStrategy wait_strategy,
+    size_t initial_capacity
+)
+    : spsc_ingress(&ingress),
+      mpsc_ingress(nullptr),
+      book(initial_capacity, ExecutionReportSink(egress)),
+      cpu(cpu),
+      wait_strategy(wait_strategy),
+      journal(nullptr),
+      uring_journal(nullptr),
+      standby(nullptr),
+      running(false),
+      fenced(false),
+      journal_full(false),
+      processed(0) {}
+
+EngineRunner::EngineRunner(
+    CommandQueue& ingress,
+    ExecutionRing& egress,
+    int cpu,
+    WaitStrategy wait_strategy,
+    size_t initial_capacity
+)
+    : spsc_ingress(nullptr),
+      mpsc_ingress(&ingress),
+      book(initial_capacity, ExecutionReportSink(egress)),
+      cpu(cpu),
+      wait_strategy(wait_strategy),
+      journal(nullptr),
+      uring_journal(nullptr),
+      standby(nullptr),
+      running(false),
+      fenced(false),
+      journal_full(false),
+      processed(0) {}
+
+EngineRunner::~EngineRunner() {
+    stop();
+}
+
+bool EngineRunner::attach_journal(UringJournal* journal) {
+    if (journal && (this->journal || !journal->is_open())) return false;
+    uring_journal = journal;
+    journal_full.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void EngineRunner::start() {
+    if (fenced.load(std::memory_order_acquire) || running.exchange(true)) return;
+    // A runner that stopped on its own (journal full) left its thread to join
+    if (worker.joinable()) {
+        worker.join();
+    }
+    worker = std::thread([this] { run(); });
+}
+
+void EngineRunner::stop() {
+    running.store(false, std::memory_order_release);
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void EngineRunner::run() {
+    if (cpu >= 0) {
+        pin_current_thread(cpu);
+    }
+    if (standby) {
+        standby->resume();
+    }
+
+    // Set when the runner stops on its own (journal full or fenced)
+    bool halted = false;
+    auto apply_one = [this, &halted](const Command& command) {
+        if (LOB_UNLIKELY(journal ? journal->is_full() : (uring_journal && !uring_journal->reserve()))) {
+            // Write-ahead: nothing is replicated or applied that was not journaled.
+            // A UringJournal with every segment in flight stops the runner too:
+            // the matching thread never waits for the disk
+            journal_full.store(true, std::memory_order_release);
+            halted = true;
+            return false;
+        }
+        if (standby && LOB_UNLIKELY(!standby->publish(command)) && standby->is_fenced()) {
+            // The follower took over: leave this command and everything after it queued
+            fenced.store(true, std::memory_order_release);
+            halted = true;
+            return false;
+        }
+        if (journal || uring_journal) {
+            journal_command(command);
+        }
+        apply_command(book, command);
+        return true;
+    };
+    unsigned idle_rounds = 0;
+    while (!halted && running.load(std::memory_order_relaxed)) {
+        size_t n = poll(apply_one);
+        if (standby) {
+            standby->heartbeat();
+        }
+        if (n != 0) {
+            processed.fetch_add(n, std::memory_order_release);
+            idle_rounds = 0;
+        } else {
+            if (uring_journal && idle_rounds == 0) {
+                persist_idle();
+            }
+            idle_wait(wait_strategy, idle_rounds++);
+        }
+    }
+
+    // Drain what the gateway enqueued before stop(); a halted runner leaves it
+    if (!halted) {
+        while (size_t n = poll(apply_one)) {
+            processed.fetch_add(n, std::memory_order_release);
+        }
+    }
+    // io_uring requests belong to the submitting thread: settle them before it exits
+    if (uring_journal) {
+        uring_journal->get_log().drain();
+    }
+    // The heartbeat stops with this thread: tell the follower not to promote
+    // (no-op once fenced or closed)
+    if (standby) {
+        standby->pause();
+    }
+    // Last: once is_running() reads false this thread touches nothing else
+    if (halted) {
+        running.store(false, std::memory_order_release);
+    }
+}
+
+void EngineRunner::journal_command(const Command& command) {
+    if (journal) {
+        journal->append(command);   // cannot fail: apply_one checked is_full()
+        return;
+    }
+    uring_journal->append(command); // cannot fail: apply_one reserved room
+}
+
+// First idle round only: post what was appended and ask for durability
+void EngineRunner::persist_idle() {
+    UringLog& log = uring_journal->get_log();
+    log.poll();
+    log.flush();
+    if (log.get_durable_bytes() != log.get_posted_bytes()) {
+        log.sync();
+    }
+}
@@ -0,0 +1,203 @@
+#include "LOB/Itch.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ItchFile::ItchFile(const char* path)
+    : fd(-1),
+      base(nullptr),
+      length(0) {
+    fd = ::open(path, O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+    length = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        ::close(fd);
+        fd = -1;
+        length = 0;
+        return;
+    }
+    // One front-to-back pass: aggressive read-ahead, pages dropped behind
+    ::madvise(mapping, length, MADV_SEQUENTIAL);
+    ::madvise(mapping, length, MADV_WILLNEED);
+    base = static_cast<const unsigned char*>(mapping);
+}
+
+ItchFile::~ItchFile() {
+    if (base) {
+        ::munmap(const_cast<unsigned char*>(base), length);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+ItchBookBuilder::ItchBookBuilder(size_t book_capacity)
+    : books(ITCH_MAX_LOCATES),
+      symbols(ITCH_MAX_LOCATES),
+      book_capacity(book_capacity),
+      book_count(0),
+      unknown_orders(0) {}
+
+void ItchBookBuilder::create_book(std::uint16_t locate) {
+    books[locate] = std::make_unique<ItchBook>(book_capacity);
+    books[locate]->set_auction_mode(true);
+    ++book_count;
+}
+
+void ItchBookBuilder::reduce(std::uint16_t locate, ID order_ref, Volume shares) {
+    ItchBook* book = books[locate].get();
+    if (LOB_UNLIKELY(!book)) {
+        ++unknown_orders;
+        return;
+    }
+    Orders& orders = book->get_id_to_order();
+    auto it = orders.find(order_ref);
+    if (LOB_UNLIKELY(it == orders.end())) {
+        ++unknown_orders;
+        return;
+    }
+    const Order* order = it->second;
+    Volume remaining = order->get_remaining_volume();
+    // Same price and less volume: shrinks in place, keeps priority; 0 deletes
+    book->amend_order(order_ref, order->get_order_price(), shares < remaining ? remaining - shares : 0);
+}
+
+void ItchBookBuilder::on_stock_directory(std::uint16_t locate, const char* stock) {
+    std::memcpy(symbols[locate].data(), stock, symbols[locate].size());
+}
+
+void ItchBookBuilder::on_delete(std::uint16_t locate, ID order_ref) {
+    ItchBook* book = books[locate].get();
+    if (LOB_UNLIKELY(!book || book->get_id_to_order().find(order_ref) == book->get_id_to_order().end())) {
+        ++unknown_orders;
+        return;
+    }
+    book->delete_order(order_ref);
+}
+
+void ItchBookBuilder::on_replace(std::uint16_t locate, ID old_ref, ID new_ref, Volume shares, PRICE price) {
+    ItchBook* book = books[locate].get();
+    if (LOB_UNLIKELY(!book)) {
+        ++unknown_orders;
+        return;
+    }
+    Orders& orders = book->get_id_to_order();
+    auto it = orders.find(old_ref);
+    if (LOB_UNLIKELY(it == orders.end())) {
+        ++unknown_orders;
+        return;
+    }
+    OrderType side = it->second->get_order_type();
+    book->delete_order(old_ref);
+    book->place_order(new_ref, 0, side, price, shares);
+}
+
+std::string ItchBookBuilder::get_symbol(std::uint16_t locate) const {
+    const std::array<char, 8>& stock = symbols[locate];
+    size_t length = stock.size();
+    while (length != 0 && (stock[length - 1] == ' ' || stock[length - 1] == '\0')) --length;
+    return std::string(stock.data(), length);
+}
+
+size_t ItchBookBuilder::get_resting_orders_count() const {
+    size_t total = 0;
+    for (const auto& book : books) {
+        if (book) total += book->get_resting_orders_count();
+    }
+    return total;
+}
+
+unsigned char* ItchWriter::begin_message(char type, std::uint16_t locate, Timestamp timestamp, size_t length) {
+    size_t offset = buffer.size();
+    buffer.resize(offset + 2 + length);
+    unsigned char* p = buffer.data() + offset;
+    p[0] = static_cast<unsigned char>(length >> 8);
+    p[1] = static_cast<unsigned char>(length);
+    unsigned char* m = p + 2;
+    std::memset(m, 0, length);
+    m[0] = static_cast<unsigned char>(type);
+    m[1] = static_cast<unsigned char>(locate >> 8);
+    m[2] = static_cast<unsigned char>(locate);
+    for (int i = 0; i < 6; ++i) {
+        m[5 + i] = static_cast<unsigned char>(timestamp >> (8 * (5 - i)));
+    }
+    return m;
+}
+
+namespace {
+
+void store_be(unsigned char* p, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        p[i] = static_cast<unsigned char>(value >> (8 * (bytes - 1 - i)));
+    }
+}
+
+void store_stock(unsigned char* p, const char* stock) {
+    size_t length = std::strlen(stock);
+    for (size_t i = 0; i < 8; ++i) {
+        p[i] = static_cast<unsigned char>(i < length ? stock[i] : ' ');
+    }
+}
+
+} // namespace
+
+void ItchWriter::stock_directory(std::uint16_t locate, Timestamp timestamp, const char* stock) {
+    unsigned char* m = begin_message(ITCH_STOCK_DIRECTORY, locate, timestamp, 39);
+    store_stock(m + 11, stock);
+    m[19] = 'Q';   // market category
+    m[20] = 'N';   // financial status
+    store_be(m + 21, 100, 4);   // round lot size
+}
+
+void ItchWriter::system_event(Timestamp timestamp, char event_code) {
+    unsigned char* m = begin_message('S', 0, timestamp, 12);
+    m[11] = static_cast<unsigned char>(event_code);
+}
+
+void ItchWriter::add_order(std::uint16_t locate, Timestamp timestamp, ID order_ref, OrderType side,
+                           Volume shares, const char* stock, PRICE price) {
+    unsigned char* m = begin_message(ITCH_ADD_ORDER, locate, timestamp, 36);
+    store_be(m + 11, order_ref, 8);
+    m[19] = side == BUY ? 'B' : 'S';
+    store_be(m + 20, shares, 4);
+    store_stock(m + 24, stock);
+    store_be(m + 32, price, 4);
+}
+
+void ItchWriter::order_executed(std::uint16_t locate, Timestamp timestamp, ID order_ref, Volume shares,
+                                std::uint64_t match_number) {
+    unsigned char* m = begin_message(ITCH_ORDER_EXECUTED, locate, timestamp, 31);
+    store_be(m + 11, order_ref, 8);
+    store_be(m + 19, shares, 4);
+    store_be(m + 23, match_number, 8);
+}
+
+void ItchWriter::order_cancel(std::uint16_t locate, Timestamp timestamp, ID order_ref, Volume shares) {
+    unsigned char* m = begin_message(ITCH_ORDER_CANCEL, locate, timestamp, 23);
+    store_be(m + 11, order_ref, 8);
+    store_be(m + 19, shares, 4);
+}
+
+void ItchWriter::order_delete(std::uint16_t locate, Timestamp timestamp, ID order_ref) {
+    unsigned char* m = begin_message(ITCH_ORDER_DELETE, locate, timestamp, 19);
+    store_be(m + 11, order_ref, 8);
+}
+
+void ItchWriter::order_replace(std::uint16_t locate, Timestamp timestamp, ID old_ref, ID new_ref,
+                               Volume shares, PRICE price) {
+    unsigned char* m = begin_message(ITCH_ORDER_REPLACE, locate, timestamp, 35);
+    store_be(m + 11, old_ref, 8);
+    store_be(m + 19, new_ref, 8);
+    store_be(m + 27, shares, 4);
+    store_be(m + 31, price, 4);
+}
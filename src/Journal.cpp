@@ -0,0 +1,178 @@
+#include "LOB/Journal.h"
+#include "LOB/Snapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+Journal::Journal(const char* path, size_t requested_capacity, std::chrono::microseconds flush_interval)
+    : fd(-1),
+      base(nullptr),
+      map_bytes(0),
+      prefault_end(0),
+      records(nullptr),
+      capacity(0),
+      recovered(0),
+      flush_interval(flush_interval),
+      write_index(0),
+      published(0),
+      durable(0),
+      running(false) {
+    if (!map_file(path, requested_capacity)) {
+        if (base) ::munmap(base, map_bytes);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+        base = nullptr;
+        records = nullptr;
+        capacity = 0;
+        return;
+    }
+
+    // Recover the valid prefix and continue after it
+    while (recovered < capacity && records[recovered].index == recovered + 1) {
+        ++recovered;
+    }
+    write_index = recovered;
+    published.store(recovered, std::memory_order_relaxed);
+    durable.store(recovered, std::memory_order_relaxed);
+    prefault(recovered);
+}
+
+Journal::~Journal() {
+    stop();
+    if (base) {
+        ::munmap(base, map_bytes);
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+bool Journal::map_file(const char* path, size_t requested_capacity) {
+    fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) return false;
+
+    JournalHeader header{};
+    bool fresh = (st.st_size < static_cast<off_t>(sizeof(JournalHeader)));
+    if (fresh) {
+        if (requested_capacity == 0) return false;
+        header.magic = JOURNAL_MAGIC;
+        header.version = JOURNAL_VERSION;
+        header.record_size = sizeof(JournalRecord);
+        header.capacity = requested_capacity;
+        map_bytes = sizeof(JournalHeader) + requested_capacity * sizeof(JournalRecord);
+        // Allocate blocks up front so appends never hit ENOSPC through SIGBUS
+        if (::posix_fallocate(fd, 0, static_cast<off_t>(map_bytes)) != 0) return false;
+    } else {
+        if (::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) return false;
+        if (header.magic != JOURNAL_MAGIC || header.version != JOURNAL_VERSION
+            || header.record_size != sizeof(JournalRecord)) {
+            return false;
+        }
+        map_bytes = sizeof(JournalHeader) + header.capacity * sizeof(JournalRecord);
+        if (static_cast<size_t>(st.st_size) < map_bytes) return false;
+    }
+
+    void* ptr = ::mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) return false;
+    base = static_cast<unsigned char*>(ptr);
+
+    if (fresh) {
+        std::memcpy(base, &header, sizeof(header));
+        if (::msync(base, sizeof(header), MS_SYNC) != 0) return false;
+    }
+
+    records = reinterpret_cast<JournalRecord*>(base + sizeof(JournalHeader));
+    capacity = header.capacity;
+    return true;
+}
+
+// Maps the pages from `from_record` up to PREFAULT_BYTES ahead writable so
+// the matching thread's appends do not fault. MADV_POPULATE_WRITE faults the
+// pages in without accessing their bytes, so it is safe while the writer runs;
+// older kernels fall back to read-ahead only.
+void Journal::prefault(std::uint64_t from_record) {
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t begin = sizeof(JournalHeader) + from_record * sizeof(JournalRecord);
+    begin -= begin % page;
+    if (begin < prefault_end) begin = prefault_end;
+    size_t end = sizeof(JournalHeader) + from_record * sizeof(JournalRecord) + PREFAULT_BYTES;
+    if (end > map_bytes) end = map_bytes;
+    if (begin >= end) return;
+#ifdef MADV_POPULATE_WRITE
+    if (::madvise(base + begin, end - begin, MADV_POPULATE_WRITE) != 0)
+#endif
+    {
+        ::madvise(base + begin, end - begin, MADV_WILLNEED);
+    }
+    prefault_end = end;
+}
+
+size_t Journal::flush() {
+    std::uint64_t end = published.load(std::memory_order_acquire);
+    std::uint64_t begin = durable.load(std::memory_order_relaxed);
+    if (end == begin) return 0;
+
+    // msync wants a page-aligned start; the range is rounded out to pages
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t first = sizeof(JournalHeader) + begin * sizeof(JournalRecord);
+    size_t last = sizeof(JournalHeader) + end * sizeof(JournalRecord);
+    first -= first % page;
+    if (::msync(base + first, last - first, MS_SYNC) != 0) {
+        return 0;
+    }
+    durable.store(end, std::memory_order_release);
+    prefault(end);
+    return end - begin;
+}
+
+void Journal::start() {
+    if (!is_open() || running.exchange(true)) return;
+    flusher = std::thread([this] { run(); });
+}
+
+void Journal::stop() {
+    running.store(false, std::memory_order_release);
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    if (is_open()) {
+        flush();
+    }
+}
+
+void Journal::run() {
+    while (running.load(std::memory_order_acquire)) {
+        flush();
+        std::this_thread::sleep_for(flush_interval);
+    }
+}
+
+bool read_journal(const char* path, std::vector<Command>& out) {
+    std::vector<unsigned char> bytes;
+    if (!read_file(path, bytes) || bytes.size() < sizeof(JournalHeader)) {
+        return false;
+    }
+    JournalHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != JOURNAL_MAGIC || header.version != JOURNAL_VERSION
+        || header.record_size != sizeof(JournalRecord)) {
+        return false;
+    }
+
+    size_t available = (bytes.size() - sizeof(JournalHeader)) / sizeof(JournalRecord);
+    out.clear();
+    out.reserve(available);
+    for (size_t i = 0; i < available; ++i) {
+        JournalRecord record;
+        std::memcpy(&record, bytes.data() + sizeof(JournalHeader) + i * sizeof(JournalRecord), sizeof(record));
+        if (record.index != i + 1) break;
+        out.push_back(record.command);
+    }
+    return true;
+}
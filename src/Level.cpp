@@ -18,7 +18,9 @@ void Level::push_back(Order* order) {
         tail = order;
     }
     
-    total_volume += order->get_remaining_volume();
+    displayed_volume += order->get_displayed_volume();
+    hidden_volume += order->get_hidden_volume();
+    displayed_orders += !order->is_hidden();
     order_number++;
 }
 
@@ -39,7 +41,9 @@ Order* Level::pop_front() {
         old_head->set_next_order(nullptr);
     }
     
-    total_volume -= old_head->get_remaining_volume();
+    displayed_volume -= old_head->get_displayed_volume();
+    hidden_volume -= old_head->get_hidden_volume();
+    displayed_orders -= !old_head->is_hidden();
     order_number--;
     
     return old_head;
@@ -75,14 +79,26 @@ void Level::erase(Order* order) {
     order->set_prev_order(nullptr);
     order->set_next_order(nullptr);
     
-    total_volume -= order->get_remaining_volume();
+    displayed_volume -= order->get_displayed_volume();
+    hidden_volume -= order->get_hidden_volume();
+    displayed_orders -= !order->is_hidden();
     order_number--;
 }
 
+void Level::replenish(Order* order) {
+    // Unlink and relink through the FIFO ops so both volume counters move the
+    // replenished tip from hidden to displayed; no allocation, no id map change.
+    erase(order);
+    order->replenish();
+    push_back(order);
+}
+
 void Level::print() const {
     std::cout << "Level Price: " << limit_price << std::endl;
     std::cout << "Number of Orders: " << order_number << std::endl;
-    std::cout << "Total Volume: " << total_volume << std::endl;
+    std::cout << "Displayed Orders: " << displayed_orders << std::endl;
+    std::cout << "Displayed Volume: " << displayed_volume << std::endl;
+    std::cout << "Hidden Volume: " << hidden_volume << std::endl;
 
     Order* current = head;
     while (current) {
@@ -9,10 +9,35 @@ void Order::fill(Volume fill_volume) {
     if (remaining_volume == 0) order_status = FULFILLED;
 }
 
+void Order::reduce(Volume volume) {
+    assert(volume <= remaining_volume && "Reduce volume exceeds remaining volume");
+    remaining_volume -= volume;
+    if (remaining_volume == 0) order_status = DELETED;
+}
+
+void Order::cancel() {
+    remaining_volume = 0;
+    reserve_volume = 0;
+    order_status = DELETED;
+}
+
 bool Order::is_fulfilled() const {
     return remaining_volume == 0;
 }
 
+void Order::hold_reserve() {
+    if (remaining_volume <= display_volume) return;
+    reserve_volume += remaining_volume - display_volume;
+    remaining_volume = display_volume;
+}
+
+void Order::replenish() {
+    Volume tip = (reserve_volume < display_volume) ? reserve_volume : display_volume;
+    reserve_volume -= tip;
+    remaining_volume += tip;
+    order_status = ACTIVE;
+}
+
 ID Order::get_order_id() const { return order_id; }
 ID Order::get_agent_id() const { return agent_id; }
 OrderType Order::get_order_type() const { return order_type; }
@@ -31,6 +56,13 @@ void Order::print() {
     std::cout << "Order Price: " << order_price << std::endl;
     std::cout << "Initial Volume: " << initial_volume << std::endl;
     std::cout << "Remaining Volume: " << remaining_volume << std::endl;
+    if (display_volume) {
+        std::cout << "Display Volume: " << display_volume << std::endl;
+        std::cout << "Reserve Volume: " << reserve_volume << std::endl;
+    }
+    if (hidden) {
+        std::cout << "Hidden: yes" << std::endl;
+    }
     std::cout << "Order Status: ";
     switch (order_status) {
         case ACTIVE:
@@ -42,5 +74,8 @@ void Order::print() {
         case DELETED:
             std::cout << "DELETED" << std::endl;
             break;
+        case PENDING:
+            std::cout << "PENDING (trigger " << trigger_price << ")" << std::endl;
+            break;
     }
 }   
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "LOB/ReplicaBook.h"
+
+ReplicaBook::ReplicaBook(size_t initial_capacity)
+    : buy_list_head(nullptr),
+      sell_list_head(nullptr),
+      order_pool(initial_capacity),
+      level_pool(initial_capacity / 16),
+      last_sequence(0) {
+    buy_side_limits.reserve(256);
+    sell_side_limits.reserve(256);
+    id_to_order.reserve(initial_capacity);
+}
+
+void ReplicaBook::apply(const BookEvent& event) {
+    last_sequence = event.sequence;
+
+    if (event.type == BEV_REST) {
+        if (LOB_LIKELY(!event.pegged)) rest(event);
+        return;
+    }
+
+    auto it = id_to_order.find(event.order_id);
+    if (it == id_to_order.end()) {
+        return; // incoming side of a fill, a peg, or a never-rested order
+    }
+    Order* order = it->second;
+
+    switch (event.type) {
+        case BEV_FILL:
+            fill(order, event.volume);
+            break;
+        case BEV_REPLENISH:
+            find_level(order)->replenish(order);
+            break;
+        case BEV_CANCEL:
+            cancel(order, event);
+            break;
+        case BEV_REST:
+            break;
+    }
+}
+
+// Rebuilds the order with its whole size and lets hold_reserve split it, exactly
+// as the primary's insert_resting_order did.
+void ReplicaBook::rest(const BookEvent& event) {
+    Volume total = event.remaining + event.reserve;
+    OrderType side = static_cast<OrderType>(event.side);
+    Order* order = order_pool.allocate(event.order_id, event.agent_id, side, event.price,
+                                       total, total, ACTIVE, event.display, event.hidden != 0);
+    if (LOB_UNLIKELY(order->is_iceberg())) {
+        order->hold_reserve();
+    }
+
+    bool is_buy = (side == BUY);
+    PriceLevelMap& limits = is_buy ? buy_side_limits : sell_side_limits;
+    auto it = limits.find(event.price);
+    Level* level;
+    if (it != limits.end()) {
+        level = it->second;
+    } else {
+        level = level_pool.allocate(event.price);
+        limits[event.price] = level;
+        if (is_buy) insert_level_descending(buy_list_head, level);
+        else insert_level_ascending(sell_list_head, level);
+    }
+    level->push_back(order);
+    id_to_order[event.order_id] = order;
+}
+
+// Mirrors match_fifo: an exhausted tip with reserve left waits for BEV_REPLENISH
+void ReplicaBook::fill(Order* order, Volume volume) {
+    Level* level = find_level(order);
+    order->fill(volume);
+    level->decrease_volume(order, volume);
+    if (order->is_fulfilled() && order->get_reserve_volume() == 0) {
+        // Already drained from the level counters; erase only unlinks it
+        remove_order(level, order);
+    }
+}
+
+// A cancel that leaves nothing removes the order with its pre-cancel volumes
+// (as the primary's erase did); a partial one (STP decrement, amend down) only
+// reduces the tip, and a following BEV_REPLENISH refills it if needed.
+void ReplicaBook::cancel(Order* order, const BookEvent& event) {
+    Level* level = find_level(order);
+    if (event.remaining + event.reserve == 0) {
+        remove_order(level, order);
+        return;
+    }
+    level->decrease_volume(order, event.volume);
+    order->reduce(event.volume);
+}
+
+Level* ReplicaBook::find_level(const Order* order) {
+    PriceLevelMap& limits = (order->get_order_type() == BUY) ? buy_side_limits : sell_side_limits;
+    return limits.find(order->get_order_price())->second;
+}
+
+void ReplicaBook::remove_order(Level* level, Order* order) {
+    bool is_buy = (order->get_order_type() == BUY);
+    level->erase(order);
+    id_to_order.erase(order->get_order_id());
+    order_pool.deallocate(order);
+
+    if (level->is_empty()) {
+        if (is_buy) unlink_level(buy_list_head, level);
+        else unlink_level(sell_list_head, level);
+        (is_buy ? buy_side_limits : sell_side_limits).erase(level->get_price());
+        level_pool.deallocate(level);
+    }
+}
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <numeric>
+#include "LOB/ShardedEngine.h"
+
+ShardedEngine::ShardedEngine(
+    size_t symbol_count,
+    size_t shard_count,
+    WaitStrategy wait_strategy,
+    const std::vector<int>& cpus,
+    size_t ring_capacity,
+    size_t book_capacity
+)
+    : symbol_to_shard(symbol_count),
+      symbol_messages(symbol_count, 0),
+      wait_strategy(wait_strategy),
+      started(false) {
+    if (shard_count == 0) shard_count = 1;
+    shards.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        int cpu = i < cpus.size() ? cpus[i] : -1;
+        shards.push_back(std::make_unique<Shard>(ring_capacity, cpu));
+    }
+
+    books.reserve(symbol_count);
+    for (size_t symbol = 0; symbol < symbol_count; ++symbol) {
+        symbol_to_shard[symbol] = static_cast<std::uint32_t>(symbol % shard_count);
+        books.push_back(std::make_unique<RunnerBook>(
+            book_capacity,
+            ExecutionReportSink(shards[symbol_to_shard[symbol]]->egress,
+                                static_cast<std::uint32_t>(symbol))));
+    }
+}
+
+ShardedEngine::~ShardedEngine() {
+    stop();
+}
+
+void ShardedEngine::start() {
+    if (started) return;
+    started = true;
+    for (auto& shard : shards) {
+        shard->running.store(true, std::memory_order_release);
+        Shard* s = shard.get();
+        shard->worker = std::thread([this, s] { run_shard(*s); });
+    }
+}
+
+void ShardedEngine::stop() {
+    if (!started) return;
+    started = false;
+    for (auto& shard : shards) {
+        shard->running.store(false, std::memory_order_release);
+    }
+    for (auto& shard : shards) {
+        if (shard->worker.joinable()) {
+            shard->worker.join();
+        }
+    }
+}
+
+void ShardedEngine::run_shard(Shard& shard) {
+    if (shard.cpu >= 0) {
+        pin_current_thread(shard.cpu);
+    }
+
+    auto apply_one = [this](const Command& command) {
+        apply_command(*books[command.symbol_id], command);
+    };
+    unsigned idle_rounds = 0;
+    while (shard.running.load(std::memory_order_relaxed)) {
+        size_t n = shard.ingress.consume(apply_one, 64);
+        if (n != 0) {
+            shard.processed.fetch_add(n, std::memory_order_release);
+            idle_rounds = 0;
+        } else {
+            idle_wait(wait_strategy, idle_rounds++);
+        }
+    }
+
+    while (size_t n = shard.ingress.consume(apply_one, 64)) {
+        shard.processed.fetch_add(n, std::memory_order_release);
+    }
+}
+
+size_t ShardedEngine::rebalance() {
+    bool was_started = started;
+    stop();
+
+    // Longest-processing-time greedy: busiest symbols first, each to the
+    // currently least loaded shard; idle symbols stay where they are
+    std::vector<std::uint32_t> order(books.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](std::uint32_t a, std::uint32_t b) {
+        return symbol_messages[a] > symbol_messages[b];
+    });
+
+    std::vector<std::uint64_t> load(shards.size(), 0);
+    size_t moved = 0;
+    for (std::uint32_t symbol : order) {
+        std::uint64_t rate = symbol_messages[symbol];
+        if (rate == 0) break;
+
+        std::uint32_t current = symbol_to_shard[symbol];
+        std::uint32_t target = current;
+        for (std::uint32_t i = 0; i < shards.size(); ++i) {
+            if (load[i] < load[target]) target = i;
+        }
+        load[target] += rate;
+        if (target != current) {
+            symbol_to_shard[symbol] = target;
+            books[symbol]->get_event_sink().set_ring(shards[target]->egress);
+            ++moved;
+        }
+    }
+    std::fill(symbol_messages.begin(), symbol_messages.end(), 0);
+
+    if (was_started) start();
+    return moved;
+}
@@ -0,0 +1,200 @@
+#include "LOB/Standby.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+
+namespace {
+
+std::uint64_t round_up_pow2(size_t n) {
+    std::uint64_t capacity = 2;
+    while (capacity < n) capacity <<= 1;
+    return capacity;
+}
+
+} // namespace
+
+StandbyPublisher::StandbyPublisher(const char* name, size_t capacity, std::chrono::milliseconds follower_timeout)
+    : fd(-1),
+      base(nullptr),
+      map_bytes(0),
+      name{},
+      header(nullptr),
+      slots(nullptr),
+      mask(0),
+      published(0),
+      cached_applied(0),
+      follower_timeout_ns(static_cast<std::uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(follower_timeout).count())),
+      replicating(false) {
+    if (!create(name, capacity)) {
+        if (base) ::munmap(base, map_bytes);
+        if (fd >= 0) {
+            ::close(fd);
+            ::shm_unlink(this->name);
+        }
+        fd = -1;
+        base = nullptr;
+        header = nullptr;
+        slots = nullptr;
+        return;
+    }
+    replicating = true;
+}
+
+StandbyPublisher::~StandbyPublisher() {
+    if (!header) return;
+    close();
+    ::munmap(base, map_bytes);
+    ::close(fd);
+    ::shm_unlink(name);
+}
+
+bool StandbyPublisher::create(const char* name, size_t capacity) {
+    if (std::strlen(name) >= sizeof(this->name) || capacity == 0) return false;
+    std::snprintf(this->name, sizeof(this->name), "%s", name);
+
+    // A crashed primary leaves its region behind; start from a fresh object
+    ::shm_unlink(name);
+    fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return false;
+
+    mask = round_up_pow2(capacity) - 1;
+    map_bytes = sizeof(StandbyRegionHeader) + (mask + 1) * sizeof(Command);
+    if (::ftruncate(fd, static_cast<off_t>(map_bytes)) != 0) return false;
+    base = ::mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        return false;
+    }
+
+    header = static_cast<StandbyRegionHeader*>(base);
+    slots = reinterpret_cast<Command*>(static_cast<unsigned char*>(base) + sizeof(StandbyRegionHeader));
+    header->version = STANDBY_VERSION;
+    header->record_size = sizeof(Command);
+    header->capacity = mask + 1;
+    header->primary_state = STANDBY_LIVE;
+    header->follower_state = STANDBY_NONE;
+    // The follower's grace period runs from creation until it attaches
+    header->follower_heartbeat_ns = standby_clock_ns();
+    heartbeat();
+    std::atomic_ref<std::uint64_t>(header->magic).store(STANDBY_MAGIC, std::memory_order_release);
+    return true;
+}
+
+bool StandbyPublisher::wait_for_space() {
+    if (!replicating) return false;
+    unsigned idle_rounds = 0;
+    for (;;) {
+        cached_applied = std::atomic_ref<std::uint64_t>(header->applied).load(std::memory_order_acquire);
+        if (published - cached_applied <= mask) return true;
+
+        std::uint64_t last_seen =
+            std::atomic_ref<std::uint64_t>(header->follower_heartbeat_ns).load(std::memory_order_acquire);
+        std::uint64_t now = standby_clock_ns();
+        if (is_fenced() || (now > last_seen && now - last_seen > follower_timeout_ns)) {
+            // Stalled, dead, never attached, or already promoted: stop replicating
+            replicating = false;
+            std::atomic_ref<std::uint32_t>(header->primary_state)
+                .store(STANDBY_DROPPED, std::memory_order_release);
+            return false;
+        }
+        // Still heartbeating while blocked, or the follower would promote
+        heartbeat();
+        idle_wait(WAIT_BACKOFF, idle_rounds++);
+    }
+}
+
+void StandbyPublisher::close() {
+    if (!header || !replicating) return;
+    std::atomic_ref<std::uint32_t>(header->primary_state).store(STANDBY_CLOSED, std::memory_order_release);
+    replicating = false;
+}
+
+void StandbyPublisher::pause() {
+    if (!header || !replicating) return;
+    std::atomic_ref<std::uint32_t>(header->primary_state).store(STANDBY_PAUSED, std::memory_order_release);
+}
+
+void StandbyPublisher::resume() {
+    if (!header || !replicating) return;
+    // Fresh heartbeat first, so going live never reads as a stale primary
+    heartbeat();
+    std::atomic_ref<std::uint32_t>(header->primary_state).store(STANDBY_LIVE, std::memory_order_release);
+}
+
+StandbyFollower::StandbyFollower(const char* name)
+    : fd(-1),
+      base(nullptr),
+      map_bytes(0),
+      header(nullptr),
+      slots(nullptr),
+      mask(0),
+      applied(0) {
+    if (!attach(name)) {
+        if (base) ::munmap(base, map_bytes);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+        base = nullptr;
+        header = nullptr;
+        slots = nullptr;
+    }
+}
+
+StandbyFollower::~StandbyFollower() {
+    if (!header) return;
+    ::munmap(base, map_bytes);
+    ::close(fd);
+}
+
+bool StandbyFollower::attach(const char* name) {
+    fd = ::shm_open(name, O_RDWR, 0);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(StandbyRegionHeader)) return false;
+    map_bytes = static_cast<size_t>(st.st_size);
+    base = ::mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        return false;
+    }
+
+    StandbyRegionHeader* region = static_cast<StandbyRegionHeader*>(base);
+    if (std::atomic_ref<std::uint64_t>(region->magic).load(std::memory_order_acquire) != STANDBY_MAGIC
+        || region->version != STANDBY_VERSION || region->record_size != sizeof(Command)
+        || region->capacity < 2 || (region->capacity & (region->capacity - 1)) != 0
+        || map_bytes < sizeof(StandbyRegionHeader) + region->capacity * sizeof(Command)) {
+        return false;
+    }
+
+    // One follower per region
+    std::uint32_t expected = STANDBY_NONE;
+    if (!std::atomic_ref<std::uint32_t>(region->follower_state)
+             .compare_exchange_strong(expected, STANDBY_LIVE, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    header = region;
+    slots = reinterpret_cast<const Command*>(static_cast<unsigned char*>(base) + sizeof(StandbyRegionHeader));
+    mask = region->capacity - 1;
+    applied = std::atomic_ref<std::uint64_t>(region->applied).load(std::memory_order_acquire);
+    std::atomic_ref<std::uint64_t>(header->follower_heartbeat_ns)
+        .store(standby_clock_ns(), std::memory_order_release);
+    return true;
+}
+
+bool StandbyFollower::primary_failed(std::chrono::nanoseconds timeout) const {
+    if (get_primary_state() != STANDBY_LIVE) return false;
+    std::uint64_t last_seen =
+        std::atomic_ref<std::uint64_t>(header->primary_heartbeat_ns).load(std::memory_order_acquire);
+    std::uint64_t now = standby_clock_ns();
+    return now > last_seen && now - last_seen > static_cast<std::uint64_t>(timeout.count());
+}
@@ -0,0 +1,413 @@
+#include "LOB/UringLog.h"
+#include "LOB/Snapshot.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::uint64_t SYNC_TAG = ~std::uint64_t{0};
+
+int io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int ring_fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+// Ring indices are shared with the kernel
+unsigned load_acquire(unsigned* p) { return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire); }
+void store_release(unsigned* p, unsigned v) { std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release); }
+
+} // namespace
+
+UringLog::UringLog(const char* path, size_t segment_bytes, unsigned segment_count)
+    : fd(-1),
+      ring_fd(-1),
+      fixed_buffers(false),
+      fixed_file(false),
+      sq_ring(nullptr),
+      sq_ring_bytes(0),
+      cq_ring(nullptr),
+      cq_ring_bytes(0),
+      sqes(nullptr),
+      sqes_bytes(0),
+      sq_tail(nullptr),
+      sq_mask(nullptr),
+      sq_array(nullptr),
+      cq_head(nullptr),
+      cq_tail(nullptr),
+      cq_mask(nullptr),
+      cqes(nullptr),
+      buffers(nullptr),
+      buffers_bytes(0),
+      segments(nullptr),
+      segment_count(segment_count),
+      segment_bytes(segment_bytes),
+      current(0),
+      cur_data(nullptr),
+      cur_used(0),
+      cur_limit(0),
+      file_offset(0),
+      appended_bytes(0),
+      completed_bytes(0),
+      durable_bytes(0),
+      sync_offset(0),
+      lost_offset(~std::uint64_t{0}),
+      sync_in_flight(false),
+      in_flight(0),
+      error(0) {
+    if (segment_count == 0 || segment_bytes == 0) return;
+
+    fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+
+    // Page-aligned buffers, one per segment
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t stride = (segment_bytes + page - 1) / page * page;
+    buffers_bytes = stride * segment_count;
+    void* mem = ::mmap(nullptr, buffers_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (mem == MAP_FAILED) {
+        buffers_bytes = 0;
+        teardown();
+        return;
+    }
+    buffers = static_cast<unsigned char*>(mem);
+    segments = new Segment[segment_count];
+    for (unsigned i = 0; i < segment_count; ++i) {
+        segments[i] = Segment{buffers + i * stride, 0, 0, 0, false};
+    }
+
+    // One write per segment plus one sync can be outstanding
+    if (!setup(segment_count + 1)) {
+        teardown();
+        return;
+    }
+
+    cur_data = segments[0].data;
+    cur_limit = segment_bytes;
+}
+
+UringLog::~UringLog() {
+    if (is_open()) {
+        drain();
+    }
+    teardown();
+}
+
+bool UringLog::setup(unsigned entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ring_fd = io_uring_setup(entries, &params);
+    if (ring_fd < 0) {
+        ring_fd = -1;
+        return false;
+    }
+
+    sq_ring_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_bytes = cq_ring_bytes = (sq_ring_bytes > cq_ring_bytes) ? sq_ring_bytes : cq_ring_bytes;
+    }
+
+    sq_ring = ::mmap(nullptr, sq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+        sq_ring = nullptr;
+        return false;
+    }
+    if (single_mmap) {
+        cq_ring = sq_ring;
+    } else {
+        cq_ring = ::mmap(nullptr, cq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED) {
+            cq_ring = nullptr;
+            return false;
+        }
+    }
+    sqes_bytes = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqe_mem = ::mmap(nullptr, sqes_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ring_fd, IORING_OFF_SQES);
+    if (sqe_mem == MAP_FAILED) {
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqe_mem);
+
+    unsigned char* sq = static_cast<unsigned char*>(sq_ring);
+    unsigned char* cq = static_cast<unsigned char*>(cq_ring);
+    sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // Registered buffers and file skip per-I/O page pinning and fd lookup;
+    // both are optional (e.g. RLIMIT_MEMLOCK on older kernels)
+    iovec* iovs = new iovec[segment_count];
+    for (unsigned i = 0; i < segment_count; ++i) {
+        iovs[i].iov_base = segments[i].data;
+        iovs[i].iov_len = segment_bytes;
+    }
+    fixed_buffers = (io_uring_register(ring_fd, IORING_REGISTER_BUFFERS, iovs, segment_count) == 0);
+    delete[] iovs;
+    fixed_file = (io_uring_register(ring_fd, IORING_REGISTER_FILES, &fd, 1) == 0);
+    return true;
+}
+
+void UringLog::teardown() {
+    if (sqes) ::munmap(sqes, sqes_bytes);
+    if (cq_ring && cq_ring != sq_ring) ::munmap(cq_ring, cq_ring_bytes);
+    if (sq_ring) ::munmap(sq_ring, sq_ring_bytes);
+    if (ring_fd >= 0) ::close(ring_fd);
+    if (buffers) ::munmap(buffers, buffers_bytes);
+    delete[] segments;
+    if (fd >= 0) ::close(fd);
+    sqes = nullptr;
+    cq_ring = sq_ring = nullptr;
+    ring_fd = -1;
+    buffers = nullptr;
+    segments = nullptr;
+    fd = -1;
+    cur_limit = 0;
+}
+
+// Outstanding SQEs never exceed the ring size (segments + one sync)
+io_uring_sqe* UringLog::next_sqe() {
+    unsigned tail = *sq_tail;
+    unsigned index = tail & *sq_mask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array[index] = index;
+    return sqe;
+}
+
+bool UringLog::enter(unsigned to_submit, unsigned min_complete) {
+    if (to_submit != 0) {
+        store_release(sq_tail, *sq_tail + to_submit);
+    }
+    unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    while (true) {
+        int ret = io_uring_enter(ring_fd, to_submit, min_complete, flags);
+        if (ret >= 0) return true;
+        if (errno != EINTR) {
+            if (!error) error = errno;
+            return false;
+        }
+    }
+}
+
+bool UringLog::post_current() {
+    Segment& segment = segments[current];
+    segment.used = cur_used;
+    segment.written = 0;
+    segment.offset = file_offset;
+    segment.in_flight = true;
+
+    file_offset += segment.used;
+    ++in_flight;
+    return post_write(current);
+}
+
+// Writes what is left of a segment: all of it, or the tail after a short write
+bool UringLog::post_write(unsigned index) {
+    const Segment& segment = segments[index];
+    io_uring_sqe* sqe = next_sqe();
+    sqe->opcode = fixed_buffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe->fd = fixed_file ? 0 : fd;
+    sqe->flags = fixed_file ? IOSQE_FIXED_FILE : 0;
+    sqe->addr = reinterpret_cast<std::uint64_t>(segment.data + segment.written);
+    sqe->len = static_cast<std::uint32_t>(segment.used - segment.written);
+    sqe->off = segment.offset + segment.written;
+    sqe->buf_index = fixed_buffers ? static_cast<std::uint16_t>(index) : 0;
+    sqe->user_data = index;
+    return enter(1, 0);
+}
+
+// Moves filling to the next segment if it is free; otherwise leaves no
+// current segment (limit 0) until poll() frees it
+bool UringLog::advance_segment() {
+    current = (current + 1) % segment_count;
+    cur_data = segments[current].data;
+    cur_used = 0;
+    if (segments[current].in_flight) {
+        poll();
+    }
+    cur_limit = segments[current].in_flight ? 0 : segment_bytes;
+    return cur_limit != 0;
+}
+
+bool UringLog::reserve_slow(size_t size) {
+    if (!is_open() || size > segment_bytes) return false;
+
+    if (cur_limit == 0) {
+        // Waiting for the current segment's write to complete
+        poll();
+        if (segments[current].in_flight) return false;
+        cur_limit = segment_bytes;
+        return true;
+    }
+    post_current();
+    return advance_segment();
+}
+
+bool UringLog::append_slow(const void* data, size_t size) {
+    if (!reserve_slow(size)) return false;
+    std::memcpy(cur_data, data, size);
+    cur_used = size;
+    appended_bytes += size;
+    return true;
+}
+
+bool UringLog::flush() {
+    if (!is_open() || cur_limit == 0 || cur_used == 0) return true;
+    bool ok = post_current();
+    advance_segment();
+    return ok;
+}
+
+bool UringLog::sync() {
+    if (!is_open() || sync_in_flight) return false;
+    io_uring_sqe* sqe = next_sqe();
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = fixed_file ? 0 : fd;
+    // Drain: runs after every write posted before it
+    sqe->flags = static_cast<std::uint8_t>((fixed_file ? IOSQE_FIXED_FILE : 0) | IOSQE_IO_DRAIN);
+    sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+    sqe->user_data = SYNC_TAG;
+    sync_offset = file_offset;
+    sync_in_flight = true;
+    return enter(1, 0);
+}
+
+size_t UringLog::poll() {
+    if (!is_open()) return 0;
+    unsigned head = *cq_head;
+    unsigned tail = load_acquire(cq_tail);
+    size_t reaped = 0;
+    while (head != tail) {
+        const io_uring_cqe& cqe = cqes[head & *cq_mask];
+        if (cqe.user_data == SYNC_TAG) {
+            if (cqe.res < 0 && !error) error = -cqe.res;
+            else durable_bytes = durable_limit(sync_offset);
+            sync_in_flight = false;
+        } else {
+            unsigned index = static_cast<unsigned>(cqe.user_data);
+            Segment& segment = segments[index];
+            if (cqe.res > 0) segment.written += static_cast<size_t>(cqe.res);
+            if (LOB_UNLIKELY(cqe.res > 0 && segment.written < segment.used)) {
+                // Short write (e.g. disk full, signal): the rest goes out at
+                // the advanced offset; the SQE slot just freed is reused
+                ++head;
+                ++reaped;
+                store_release(cq_head, head);
+                post_write(index);
+                continue;
+            }
+            if (cqe.res <= 0) {
+                // Failed, or no progress: the tail of the segment is lost
+                if (!error) error = cqe.res < 0 ? -cqe.res : EIO;
+                if (segment.offset + segment.written < lost_offset) lost_offset = segment.offset + segment.written;
+            } else {
+                completed_bytes += segment.used;
+            }
+            segment.used = 0;
+            segment.in_flight = false;
+            --in_flight;
+        }
+        ++head;
+        ++reaped;
+    }
+    store_release(cq_head, head);
+    return reaped;
+}
+
+// A sync drained behind a write covers only the part that write had
+// completed (a resubmitted tail is posted after the sync), and nothing past
+// a failed write
+std::uint64_t UringLog::durable_limit(std::uint64_t offset) const {
+    if (lost_offset < offset) offset = lost_offset;
+    for (unsigned i = 0; i < segment_count; ++i) {
+        const Segment& segment = segments[i];
+        if (segment.in_flight && segment.offset < offset && segment.offset + segment.written < offset) {
+            offset = segment.offset + segment.written;
+        }
+    }
+    return offset;
+}
+
+void UringLog::drain() {
+    if (!is_open()) return;
+    flush();
+    while (in_flight != 0 || sync_in_flight) {
+        if (poll() == 0 && !enter(0, 1)) break;
+    }
+    if (cur_limit == 0 && !segments[current].in_flight) {
+        cur_limit = segment_bytes;
+    }
+    if (sync()) {
+        while (sync_in_flight) {
+            if (poll() == 0 && !enter(0, 1)) break;
+        }
+    }
+}
+
+UringJournal::UringJournal(const char* path, size_t segment_bytes, unsigned segment_count)
+    : log(path, segment_bytes, segment_count),
+      index(0),
+      header_written(false) {
+    JournalHeader header{};
+    header.magic = JOURNAL_MAGIC;
+    header.version = JOURNAL_VERSION;
+    header.record_size = sizeof(JournalRecord);
+    header.capacity = 0;
+    // Header and record are both one cache line: if one fits, so does the other
+    header_written = log.append(header);
+}
+
+UringEventLog::UringEventLog(const char* path, size_t segment_bytes, unsigned segment_count)
+    : log(path, segment_bytes, segment_count),
+      appended(0),
+      header_written(false) {
+    EventLogHeader header{};
+    header.magic = EVENT_LOG_MAGIC;
+    header.version = EVENT_LOG_VERSION;
+    header.record_size = sizeof(ExecutionReport);
+    header_written = log.append(header);
+}
+
+bool read_event_log(const char* path, std::vector<ExecutionReport>& out) {
+    std::vector<unsigned char> bytes;
+    if (!read_file(path, bytes) || bytes.size() < sizeof(EventLogHeader)) {
+        return false;
+    }
+    EventLogHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != EVENT_LOG_MAGIC || header.version != EVENT_LOG_VERSION
+        || header.record_size != sizeof(ExecutionReport)) {
+        return false;
+    }
+
+    size_t count = (bytes.size() - sizeof(EventLogHeader)) / sizeof(ExecutionReport);
+    out.resize(count);
+    if (count != 0) {
+        std::memcpy(out.data(), bytes.data() + sizeof(EventLogHeader), count * sizeof(ExecutionReport));
+    }
+    return true;
+}
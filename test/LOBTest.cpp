@@ -1,8 +1,33 @@
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <type_traits>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <random>
+#include <filesystem>
+#include <functional>
+#include <csignal>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include "LOB/Book.h"
 #include "LOB/Order.h"
 #include "LOB/Level.h"
+#include "LOB/TimingWheel.h"
+#include "LOB/ExecutionReport.h"
+#include "LOB/L2Feed.h"
+#include "LOB/EngineRunner.h"
+#include "LOB/ShardedEngine.h"
+#include "LOB/Pipeline.h"
+#include "LOB/ReplicaBook.h"
+#include "LOB/Journal.h"
+#include "LOB/EventHash.h"
+#include "LOB/UringLog.h"
+#include "LOB/CompactJournal.h"
+#include "LOB/Standby.h"
+#include "LOB/Itch.h"
 
 // Order Tests
 TEST(order_test, fill_order_beyond_volume) {
@@ -375,6 +400,2582 @@ TEST(book_test, pool_reuse_no_memory_growth) {
     EXPECT_EQ(book.get_resting_orders_count(), 0);
 }
 
+// Iceberg / Hidden Order Tests
+TEST(iceberg_test, level_splits_displayed_and_hidden_volume) {
+    Book book;
+
+    book.place_iceberg_order(1, 1, SELL, 100, 100, 10);
+    book.place_hidden_order(2, 1, SELL, 100, 30);
+    book.place_order(3, 1, SELL, 100, 5);
+
+    Level* level = book.get_sell_limits().find(100)->second;
+    EXPECT_EQ(level->get_displayed_volume(), 15);
+    EXPECT_EQ(level->get_hidden_volume(), 120);
+    EXPECT_EQ(level->get_total_volume(), 135);
+}
+
+TEST(iceberg_test, tip_replenishes_at_tail) {
+    Book book;
+
+    book.place_iceberg_order(1, 1, SELL, 100, 25, 10);
+    book.place_order(2, 1, SELL, 100, 5);
+
+    const Trades& trades = book.place_order(3, 2, BUY, 100, 12);
+
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].get_matched_order(), 1);
+    EXPECT_EQ(trades[0].get_trade_volume(), 10);
+    EXPECT_EQ(trades[1].get_matched_order(), 2);
+    EXPECT_EQ(trades[1].get_trade_volume(), 2);
+
+    Level* level = book.get_sell_limits().find(100)->second;
+    EXPECT_EQ(level->get_head()->get_order_id(), 2);
+    EXPECT_EQ(level->get_tail()->get_order_id(), 1);
+    EXPECT_EQ(level->get_displayed_volume(), 13);
+    EXPECT_EQ(level->get_hidden_volume(), 5);
+    EXPECT_EQ(book.get_resting_orders_count(), 2);
+}
+
+TEST(iceberg_test, sweep_consumes_reserve) {
+    Book book;
+
+    book.place_iceberg_order(1, 1, SELL, 100, 25, 10);
+
+    const Trades& trades = book.place_order(2, 2, BUY, 100, 30);
+
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_EQ(trades[2].get_trade_volume(), 5);
+    EXPECT_EQ(book.get_sell_levels_count(), 0);
+    EXPECT_EQ(book.get_best_buy(), 100);
+    EXPECT_EQ(book.get_resting_orders_count(), 1);
+}
+
+TEST(iceberg_test, hidden_order_matches_and_cancels) {
+    Book book;
+
+    book.place_hidden_order(1, 1, BUY, 100, 30);
+    const Trades& trades = book.place_order(2, 2, SELL, 100, 10);
+
+    ASSERT_EQ(trades.size(), 1);
+    Level* level = book.get_buy_limits().find(100)->second;
+    EXPECT_EQ(level->get_displayed_volume(), 0);
+    EXPECT_EQ(level->get_hidden_volume(), 20);
+
+    book.delete_order(1);
+    EXPECT_EQ(book.get_buy_levels_count(), 0);
+}
+
+// Matching Policy Tests
+TEST(pro_rata_test, allocates_by_size) {
+    BasicBook<ProRataMatching<>> book;
+
+    book.place_order(1, 1, SELL, 100, 10);
+    book.place_order(2, 1, SELL, 100, 30);
+    book.place_order(3, 1, SELL, 100, 60);
+
+    const Trades& trades = book.place_order(4, 2, BUY, 100, 50);
+
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_EQ(trades[0].get_matched_order(), 1);
+    EXPECT_EQ(trades[0].get_trade_volume(), 5);
+    EXPECT_EQ(trades[1].get_trade_volume(), 15);
+    EXPECT_EQ(trades[2].get_trade_volume(), 30);
+    EXPECT_EQ(book.get_sell_limits().find(100)->second->get_total_volume(), 50);
+}
+
+TEST(pro_rata_test, rounding_residue_goes_fifo) {
+    BasicBook<ProRataMatching<>> book;
+
+    book.place_order(1, 1, SELL, 100, 10);
+    book.place_order(2, 1, SELL, 100, 10);
+    book.place_order(3, 1, SELL, 100, 10);
+
+    const Trades& trades = book.place_order(4, 2, BUY, 100, 10);
+
+    Volume to_first = 0;
+    Volume total = 0;
+    for (const Trade& t : trades) {
+        total += t.get_trade_volume();
+        if (t.get_matched_order() == 1) to_first += t.get_trade_volume();
+    }
+    EXPECT_EQ(total, 10);
+    EXPECT_EQ(to_first, 4);
+    EXPECT_EQ(book.get_resting_orders_count(), 3);
+}
+
+TEST(pro_rata_test, top_order_allocation) {
+    BasicBook<ProRataMatching<50>> book;
+
+    book.place_order(1, 1, SELL, 100, 40);
+    book.place_order(2, 1, SELL, 100, 40);
+
+    const Trades& trades = book.place_order(3, 2, BUY, 100, 40);
+
+    ASSERT_EQ(trades.size(), 4);
+    EXPECT_EQ(trades[0].get_matched_order(), 1);
+    EXPECT_EQ(trades[0].get_trade_volume(), 20);
+    // 20 left over 60 displayed: 1 gets 20*20/60 = 6, 2 gets 20*40/60 = 13
+    EXPECT_EQ(trades[1].get_trade_volume(), 6);
+    EXPECT_EQ(trades[2].get_trade_volume(), 13);
+    // Rounding residue goes to the head
+    EXPECT_EQ(trades[3].get_matched_order(), 1);
+    EXPECT_EQ(trades[3].get_trade_volume(), 1);
+    EXPECT_EQ(book.get_order_status(1), ACTIVE);
+}
+
+TEST(pro_rata_test, sweep_fills_everything) {
+    BasicBook<ProRataMatching<>> book;
+
+    book.place_order(1, 1, SELL, 100, 10);
+    book.place_order(2, 1, SELL, 101, 10);
+
+    const Trades& trades = book.place_order(3, 2, BUY, 101, 25);
+
+    EXPECT_EQ(trades.size(), 2);
+    EXPECT_EQ(book.get_sell_levels_count(), 0);
+    EXPECT_EQ(book.get_best_buy(), 101);
+}
+
+// Auction Tests
+TEST(auction_test, orders_rest_crossed_without_matching) {
+    Book book;
+    book.set_auction_mode(true);
+
+    const Trades& trades = book.place_order(1, 1, BUY, 105, 10);
+    EXPECT_EQ(trades.size(), 0);
+    book.place_order(2, 2, SELL, 100, 10);
+
+    EXPECT_EQ(book.get_best_buy(), 105);
+    EXPECT_EQ(book.get_best_sell(), 100);
+    EXPECT_EQ(book.get_resting_orders_count(), 2);
+    EXPECT_EQ(book.get_spread(), 0);
+}
+
+TEST(auction_test, indicative_price_maximizes_volume) {
+    Book book;
+    book.set_auction_mode(true);
+
+    book.place_order(1, 1, BUY, 103, 10);
+    book.place_order(2, 1, BUY, 102, 20);
+    book.place_order(3, 1, BUY, 100, 30);
+    book.place_order(4, 2, SELL, 99, 15);
+    book.place_order(5, 2, SELL, 101, 25);
+    book.place_order(6, 2, SELL, 104, 10);
+
+    // At 102: bids 30, asks 40 -> 30; at 101 bids 30, asks 40 -> 30; ask surplus at 101
+    UncrossResult result = book.get_indicative_uncross();
+    EXPECT_EQ(result.volume, 30);
+    EXPECT_EQ(result.price, 101);
+}
+
+TEST(auction_test, uncross_executes_at_single_price) {
+    Book book;
+    book.set_auction_mode(true);
+
+    book.place_order(1, 1, BUY, 103, 10);
+    book.place_order(2, 1, BUY, 102, 20);
+    book.place_order(3, 1, BUY, 100, 30);
+    book.place_order(4, 2, SELL, 99, 15);
+    book.place_order(5, 2, SELL, 101, 25);
+    book.place_order(6, 2, SELL, 104, 10);
+
+    const Trades& trades = book.uncross();
+
+    Volume total = 0;
+    for (const Trade& t : trades) {
+        EXPECT_EQ(t.get_trade_price(), 101);
+        total += t.get_trade_volume();
+    }
+    EXPECT_EQ(total, 30);
+    EXPECT_FALSE(book.in_auction());
+    EXPECT_EQ(book.get_best_buy(), 100);
+    EXPECT_EQ(book.get_best_sell(), 101);
+    EXPECT_EQ(book.get_sell_limits().find(101)->second->get_total_volume(), 10);
+    EXPECT_EQ(book.get_order_status(1), DELETED);
+    EXPECT_EQ(book.get_order_status(5), ACTIVE);
+}
+
+TEST(auction_test, balanced_book_clears_at_midpoint) {
+    Book book;
+    book.set_auction_mode(true);
+
+    book.place_order(1, 1, BUY, 110, 10);
+    book.place_order(2, 2, SELL, 100, 10);
+
+    const Trades& trades = book.uncross();
+
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].get_trade_price(), 105);
+    EXPECT_EQ(trades[0].get_incoming_order(), 1);
+    EXPECT_EQ(trades[0].get_matched_order(), 2);
+    EXPECT_EQ(book.get_resting_orders_count(), 0);
+}
+
+TEST(auction_test, uncross_without_cross_is_empty) {
+    Book book;
+    book.set_auction_mode(true);
+
+    book.place_order(1, 1, BUY, 99, 10);
+    book.place_order(2, 2, SELL, 100, 10);
+
+    EXPECT_EQ(book.uncross().size(), 0);
+    EXPECT_EQ(book.get_resting_orders_count(), 2);
+}
+
+// Stop Order Tests
+TEST(stop_test, pending_until_triggered) {
+    Book book;
+
+    book.place_order(1, 1, SELL, 105, 10);
+    book.place_stop_limit_order(2, 2, BUY, 102, 105, 10);
+
+    EXPECT_EQ(book.get_order_status(2), PENDING);
+    EXPECT_EQ(book.get_pending_stops_count(), 1);
+    EXPECT_EQ(book.get_resting_orders_count(), 1);
+
+    // Trade at 101 does not reach the 102 trigger
+    book.place_order(3, 3, SELL, 101, 5);
+    book.place_order(4, 4, BUY, 101, 5);
+    EXPECT_EQ(book.get_last_trade_price(), 101);
+    EXPECT_EQ(book.get_order_status(2), PENDING);
+}
+
+TEST(stop_test, buy_stop_limit_triggers_and_matches) {
+    Book book;
+
+    book.place_order(1, 1, SELL, 102, 5);
+    book.place_order(2, 1, SELL, 105, 10);
+    book.place_stop_limit_order(3, 2, BUY, 102, 105, 10);
+
+    const Trades& trades = book.place_order(4, 3, BUY, 102, 5);
+
+    // Triggering trade, then the activated stop sweeps 105
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].get_incoming_order(), 4);
+    EXPECT_EQ(trades[1].get_incoming_order(), 3);
+    EXPECT_EQ(trades[1].get_trade_price(), 105);
+    EXPECT_EQ(book.get_pending_stops_count(), 0);
+    EXPECT_EQ(book.get_sell_levels_count(), 0);
+}
+
+TEST(stop_test, stop_market_cancels_unfilled_remainder) {
+    Book book;
+
+    book.place_order(1, 1, BUY, 100, 5);
+    book.place_order(2, 1, BUY, 95, 5);
+    book.place_stop_order(3, 2, SELL, 100, 20);
+
+    const Trades& trades = book.place_order(4, 3, SELL, 100, 2);
+
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_EQ(trades[1].get_trade_volume(), 3);
+    EXPECT_EQ(trades[2].get_trade_price(), 95);
+    EXPECT_EQ(book.get_buy_levels_count(), 0);
+    EXPECT_EQ(book.get_sell_levels_count(), 0);
+    EXPECT_EQ(book.get_order_status(3), DELETED);
+}
+
+TEST(stop_test, triggers_in_price_then_time_order) {
+    Book book;
+
+    book.place_order(1, 1, SELL, 100, 1);
+    book.place_order(2, 1, SELL, 110, 30);
+    book.place_stop_limit_order(10, 2, BUY, 100, 110, 1);
+    book.place_stop_limit_order(11, 2, BUY, 99, 110, 1);
+    book.place_stop_limit_order(12, 2, BUY, 100, 110, 1);
+    book.place_stop_limit_order(13, 2, BUY, 120, 110, 1);
+
+    const Trades& trades = book.place_order(3, 3, BUY, 100, 1);
+
+    ASSERT_EQ(trades.size(), 4);
+    EXPECT_EQ(trades[1].get_incoming_order(), 11);
+    EXPECT_EQ(trades[2].get_incoming_order(), 10);
+    EXPECT_EQ(trades[3].get_incoming_order(), 12);
+    EXPECT_EQ(book.get_order_status(13), PENDING);
+}
+
+TEST(stop_test, delete_pending_stop) {
+    Book book;
+
+    book.place_stop_order(1, 1, SELL, 90, 10);
+    book.delete_order(1);
+
+    EXPECT_EQ(book.get_order_status(1), DELETED);
+    EXPECT_EQ(book.get_pending_stops_count(), 0);
+}
+
+TEST(stop_test, triggers_deferred_during_call_phase) {
+    Book book;
+
+    book.place_order(1, 1, SELL, 100, 5);
+    book.place_order(2, 2, BUY, 100, 5);
+    ASSERT_EQ(book.get_last_trade_price(), 100);
+
+    // Already past its trigger, but nothing may execute before the uncross
+    book.set_auction_mode(true);
+    book.place_order(3, 3, SELL, 105, 10);
+    book.place_stop_order(4, 4, BUY, 95, 10);
+    EXPECT_EQ(book.get_order_status(4), PENDING);
+    EXPECT_EQ(book.get_best_buy(), 0);
+    EXPECT_EQ(book.get_indicative_uncross().volume, 0);
+
+    // The stop-market fires once matching resumes and sweeps the ask
+    const Trades& trades = book.uncross();
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].get_incoming_order(), 4);
+    EXPECT_EQ(trades[0].get_trade_price(), 105);
+    EXPECT_EQ(book.get_pending_stops_count(), 0);
+    EXPECT_EQ(book.get_buy_levels_count(), 0);
+}
+
+// Timing Wheel / Good-Till-Time Tests
+TEST(timing_wheel_test, expires_in_time_order_across_levels) {
+    TimingWheel wheel(1000);
+    std::vector<Order> orders;
+    orders.reserve(5);
+    Timestamp expiries[] = {1001, 1064, 5000, 1000000, 1ULL << 40};
+    for (ID i = 0; i < 5; ++i) {
+        orders.emplace_back(i, 1, BUY, 100, 10, 10, ACTIVE);
+        orders.back().set_expire_time(expiries[i]);
+        wheel.schedule(&orders.back());
+    }
+
+    std::vector<ID> expired;
+    auto collect = [&expired](Order* o) { expired.push_back(o->get_order_id()); };
+
+    wheel.advance(1063, collect);
+    EXPECT_EQ(expired, std::vector<ID>({0}));
+    wheel.advance(999999, collect);
+    EXPECT_EQ(expired, std::vector<ID>({0, 1, 2}));
+    wheel.advance(1ULL << 41, collect);
+    EXPECT_EQ(expired, std::vector<ID>({0, 1, 2, 3, 4}));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timing_wheel_test, cancel_unlinks_timer) {
+    TimingWheel wheel;
+    Order a(1, 1, BUY, 100, 10, 10, ACTIVE);
+    Order b(2, 1, BUY, 100, 10, 10, ACTIVE);
+    a.set_expire_time(50);
+    b.set_expire_time(50);
+    wheel.schedule(&a);
+    wheel.schedule(&b);
+
+    wheel.cancel(&b);
+
+    size_t count = 0;
+    wheel.advance(100, [&count](Order*) { ++count; });
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(gtd_test, advance_time_expires_resting_orders) {
+    Book book;
+
+    book.place_order(1, 1, BUY, 100, 10, 500);
+    book.place_order(2, 1, BUY, 101, 10, 2000);
+    book.place_order(3, 1, BUY, 99, 10);
+
+    EXPECT_EQ(book.get_timed_orders_count(), 2);
+    EXPECT_EQ(book.advance_time(499), 0);
+    EXPECT_EQ(book.advance_time(1500), 1);
+    EXPECT_EQ(book.get_order_status(1), DELETED);
+    EXPECT_EQ(book.get_best_buy(), 101);
+
+    EXPECT_EQ(book.advance_time(2000), 1);
+    EXPECT_EQ(book.get_best_buy(), 99);
+    EXPECT_EQ(book.get_resting_orders_count(), 1);
+}
+
+TEST(gtd_test, filled_and_cancelled_orders_leave_the_wheel) {
+    Book book;
+
+    book.place_order(1, 1, BUY, 100, 10, 500);
+    book.place_order(2, 1, BUY, 100, 10, 500);
+    book.place_order(3, 2, SELL, 100, 10);
+    book.delete_order(2);
+
+    EXPECT_EQ(book.get_timed_orders_count(), 0);
+    EXPECT_EQ(book.advance_time(1000), 0);
+}
+
+TEST(gtd_test, rejects_expiry_in_the_past) {
+    Book book;
+    book.advance_time(100);
+
+    book.place_order(1, 1, BUY, 100, 10, 100);
+
+    EXPECT_EQ(book.get_resting_orders_count(), 0);
+}
+
+// Pegged Order Tests
+TEST(peg_test, primary_peg_follows_best_bid_lazily) {
+    Book book;
+
+    book.place_order(1, 1, BUY, 100, 10);
+    book.place_pegged_order(2, 1, BUY, PEG_PRIMARY, 10);
+    book.place_order(3, 1, BUY, 102, 5);
+
+    EXPECT_EQ(book.get_pegged_orders_count(), 1);
+    EXPECT_EQ(book.get_best_buy(), 102);
+
+    // Peg now tracks 102 and trades right after the 102 level's own order
+    const Trades& trades = book.place_order(4, 2, SELL, 102, 8);
+
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].get_matched_order(), 3);
+    EXPECT_EQ(trades[1].get_matched_order(), 2);
+    EXPECT_EQ(trades[1].get_trade_price(), 102);
+    EXPECT_EQ(trades[1].get_trade_volume(), 3);
+    EXPECT_EQ(book.get_best_buy(), 100);
+}
+
+TEST(peg_test, midpoint_peg_trades_ahead_of_best_level) {
+    Book book;
+
+    book.place_order(1, 1, BUY, 100, 10);
+    book.place_order(2, 1, SELL, 110, 10);
+    book.place_pegged_order(3, 3, SELL, PEG_MIDPOINT, 5);
+
+    const Trades& trades = book.place_order(4, 2, BUY, 110, 8);
+
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].get_matched_order(), 3);
+    EXPECT_EQ(trades[0].get_trade_price(), 105);
+    EXPECT_EQ(trades[1].get_matched_order(), 2);
+    EXPECT_EQ(trades[1].get_trade_price(), 110);
+    EXPECT_EQ(book.get_pegged_orders_count(), 0);
+}
+
+TEST(peg_test, midpoint_peg_respects_limit_of_incoming) {
+    Book book;
+
+    book.place_order(1, 1, BUY, 100, 10);
+    book.place_order(2, 1, SELL, 111, 10);
+    book.place_pegged_order(3, 3, SELL, PEG_MIDPOINT, 5);
+
+    // Sell mid peg prices at ceil(105.5) = 106
+    const Trades& trades = book.place_order(4, 2, BUY, 105, 8);
+
+    EXPECT_EQ(trades.size(), 0);
+    EXPECT_EQ(book.get_best_buy(), 105);
+    EXPECT_EQ(book.get_pegged_orders_count(), 1);
+}
+
+TEST(peg_test, midpoint_pegs_cross_at_whole_tick) {
+    Book book;
+
+    book.place_order(1, 1, BUY, 100, 10);
+    book.place_order(2, 1, SELL, 110, 10);
+    book.place_pegged_order(3, 2, BUY, PEG_MIDPOINT, 5);
+    const Trades& trades = book.place_pegged_order(4, 3, SELL, PEG_MIDPOINT, 8);
+
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].get_trade_price(), 105);
+    EXPECT_EQ(trades[0].get_trade_volume(), 5);
+    EXPECT_EQ(book.get_order_status(4), ACTIVE);
+}
+
+TEST(peg_test, dormant_without_reference_and_cancellable) {
+    Book book;
+
+    book.place_pegged_order(1, 1, SELL, PEG_PRIMARY, 5);
+    const Trades& trades = book.place_order(2, 2, BUY, 100, 5);
+
+    EXPECT_EQ(trades.size(), 0);
+    book.delete_order(1);
+    EXPECT_EQ(book.get_pegged_orders_count(), 0);
+    EXPECT_EQ(book.get_order_status(1), DELETED);
+}
+
+// Amend Tests
+TEST(amend_test, size_down_keeps_priority) {
+    Book book;
+    book.place_order(1, 1, SELL, 100, 10);
+    book.place_order(2, 2, SELL, 100, 10);
+
+    book.amend_order(1, 100, 4);
+    EXPECT_EQ(book.get_sell_limits().find(100)->second->get_total_volume(), 14);
+
+    const Trades& trades = book.place_order(3, 3, BUY, 100, 4);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].get_matched_order(), 1);
+}
+
+TEST(amend_test, price_change_reenters_and_can_match) {
+    Book book;
+    book.place_order(1, 1, SELL, 101, 10);
+    book.place_order(2, 2, BUY, 99, 5);
+
+    const Trades& trades = book.amend_order(2, 101, 5);
+
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].get_incoming_order(), 2);
+    EXPECT_EQ(book.get_buy_levels_count(), 0);
+    EXPECT_EQ(book.get_sell_limits().find(101)->second->get_total_volume(), 5);
+}
+
+TEST(amend_test, size_up_loses_priority) {
+    Book book;
+    book.place_order(1, 1, SELL, 100, 10);
+    book.place_order(2, 2, SELL, 100, 10);
+
+    book.amend_order(1, 100, 12);
+
+    EXPECT_EQ(book.get_sell_limits().find(100)->second->get_head()->get_order_id(), 2);
+    EXPECT_EQ(book.get_sell_limits().find(100)->second->get_total_volume(), 22);
+}
+
+TEST(amend_test, pending_stop_and_unknown_id_are_ignored) {
+    Book book;
+    book.place_stop_order(1, 1, SELL, 90, 10);
+
+    EXPECT_EQ(book.amend_order(1, 95, 5).size(), 0);
+    EXPECT_EQ(book.amend_order(1, 90, 0).size(), 0);
+    book.amend_order(42, 100, 5);
+
+    EXPECT_EQ(book.get_pending_stops_count(), 1);
+    EXPECT_EQ(book.get_order_status(1), PENDING);
+    EXPECT_EQ(book.get_resting_orders_count(), 0);
+}
+
+// Post-Only Tests
+TEST(post_only_test, rests_when_not_crossing) {
+    Book book;
+
+    book.place_order(1, 1, SELL, 105, 10);
+
+    PRICE rested = 0;
+    EXPECT_EQ(book.place_post_only_order(2, 2, BUY, 104, 10, POST_ONLY_REJECT, &rested).size(), 0);
+    EXPECT_EQ(rested, 104);
+    EXPECT_EQ(book.get_best_buy(), 104);
+    EXPECT_EQ(book.get_sell_limits().find(105)->second->get_total_volume(), 10);
+}
+
+TEST(post_only_test, rejects_when_crossing) {
+    Book book;
+
+    book.place_order(1, 1, SELL, 105, 10);
+
+    PRICE rested = 1;
+    book.place_post_only_order(2, 2, BUY, 105, 10, POST_ONLY_REJECT, &rested);
+    EXPECT_EQ(rested, 0);
+    EXPECT_EQ(book.get_buy_levels_count(), 0);
+    EXPECT_EQ(book.get_order_status(2), DELETED);
+    EXPECT_EQ(book.get_sell_limits().find(105)->second->get_total_volume(), 10);
+}
+
+TEST(post_only_test, slides_one_tick_off_opposite_side) {
+    Book book;
+
+    book.place_order(1, 1, SELL, 105, 10);
+    book.place_order(2, 1, BUY, 100, 10);
+
+    PRICE rested = 0;
+    book.place_post_only_order(3, 2, BUY, 110, 10, POST_ONLY_SLIDE, &rested);
+    EXPECT_EQ(rested, 104);
+    book.place_post_only_order(4, 2, SELL, 90, 10, POST_ONLY_SLIDE, &rested);
+    EXPECT_EQ(rested, 105);
+    EXPECT_EQ(book.get_best_buy(), 104);
+    EXPECT_EQ(book.get_best_sell(), 105);
+    EXPECT_EQ(book.get_sell_limits().find(105)->second->get_order_number(), 2);
+}
+
+TEST(post_only_test, result_holds_only_this_call) {
+    Book book;
+
+    book.place_order(1, 1, SELL, 100, 10);
+    ASSERT_EQ(book.place_order(2, 2, BUY, 100, 4).size(), 1);
+
+    // Previous call's trade must not leak into the post-only result
+    EXPECT_EQ(book.place_post_only_order(3, 2, BUY, 99, 10).size(), 0);
+    EXPECT_EQ(book.place_post_only_order(4, 2, BUY, 100, 10).size(), 0);
+    EXPECT_EQ(book.get_order_status(4), DELETED);
+}
+
+// Event Sink Tests
+struct RecordingSink : NullEventSink {
+    struct Event {
+        char kind;   // 'T'rade, 'R'est, 'P' replenish, 'C'ancel
+        ID order_id;
+        Volume volume;
+    };
+    std::vector<Event> events;
+
+    void on_trade(const Order& incoming, const Order&, PRICE, Volume volume) {
+        events.push_back({'T', incoming.get_order_id(), volume});
+    }
+    void on_rest(const Order& order) {
+        events.push_back({'R', order.get_order_id(), order.get_remaining_volume()});
+    }
+    void on_replenish(const Order& order) {
+        events.push_back({'P', order.get_order_id(), order.get_remaining_volume()});
+    }
+    void on_cancel(const Order& order, Volume cancelled_volume, CancelReason) {
+        events.push_back({'C', order.get_order_id(), cancelled_volume});
+    }
+};
+
+TEST(event_sink_test, reports_rest_trade_and_cancel_in_order) {
+    BasicBook<FifoMatching, RecordingSink> book;
+
+    book.place_order(1, 1, SELL, 100, 10);
+    book.place_order(2, 2, BUY, 100, 4);
+    book.delete_order(1);
+
+    const auto& events = book.get_event_sink().events;
+    ASSERT_EQ(events.size(), 3);
+    EXPECT_EQ(events[0].kind, 'R');
+    EXPECT_EQ(events[1].kind, 'T');
+    EXPECT_EQ(events[1].order_id, 2);
+    EXPECT_EQ(events[1].volume, 4);
+    EXPECT_EQ(events[2].kind, 'C');
+    EXPECT_EQ(events[2].order_id, 1);
+    EXPECT_EQ(events[2].volume, 6);
+}
+
+TEST(event_sink_test, reports_iceberg_replenish_after_fill) {
+    BasicBook<FifoMatching, RecordingSink> book;
+
+    book.place_iceberg_order(1, 1, SELL, 100, 10, 3);
+    book.place_order(2, 2, BUY, 100, 3);
+
+    const auto& events = book.get_event_sink().events;
+    ASSERT_EQ(events.size(), 3);
+    EXPECT_EQ(events[1].kind, 'T');
+    EXPECT_EQ(events[2].kind, 'P');
+    EXPECT_EQ(events[2].volume, 3);
+}
+
+TEST(event_sink_test, null_sink_returns_nothing) {
+    BasicBook<FifoMatching, NullEventSink> book;
+
+    static_assert(std::is_void<decltype(book.place_order(1, 1, SELL, 100, 10))>::value,
+                  "NullEventSink book must not return a result");
+    book.place_order(1, 1, SELL, 100, 10);
+    book.place_order(2, 2, BUY, 100, 10);
+
+    EXPECT_EQ(book.get_resting_orders_count(), 0);
+}
+
+// Depth Snapshot Tests
+TEST(depth_snapshot_test, fills_top_levels_best_first) {
+    Book book;
+    book.place_order(1, 1, BUY, 99, 10);
+    book.place_order(2, 1, BUY, 98, 5);
+    book.place_order(3, 1, BUY, 99, 3);
+    book.place_order(4, 1, BUY, 97, 1);
+    book.place_order(5, 2, SELL, 101, 4);
+
+    LevelView bids[2];
+    LevelView asks[2];
+    DepthCount count = book.snapshot_depth(2, bids, asks);
+
+    ASSERT_EQ(count.bids, 2);
+    ASSERT_EQ(count.asks, 1);
+    EXPECT_EQ(bids[0].price, 99);
+    EXPECT_EQ(bids[0].volume, 13);
+    EXPECT_EQ(bids[0].order_count, 2);
+    EXPECT_EQ(bids[1].price, 98);
+    EXPECT_EQ(asks[0].price, 101);
+    EXPECT_EQ(asks[0].volume, 4);
+}
+
+TEST(depth_snapshot_test, capped_by_buffer_size) {
+    Book book;
+    for (ID i = 1; i <= 5; ++i) {
+        book.place_order(i, 1, SELL, 100 + static_cast<PRICE>(i), 1);
+    }
+
+    LevelView asks[3];
+    DepthCount count = book.snapshot_depth(10, {}, asks);
+
+    EXPECT_EQ(count.bids, 0);
+    ASSERT_EQ(count.asks, 3);
+    EXPECT_EQ(asks[2].price, 103);
+}
+
+TEST(depth_snapshot_test, hidden_orders_stay_out_of_rows) {
+    Book book;
+    book.place_order(1, 1, BUY, 100, 10);
+    book.place_hidden_order(2, 1, BUY, 105, 50);
+    book.place_hidden_order(3, 1, BUY, 100, 20);
+
+    LevelView bids[2];
+    DepthCount count = book.snapshot_depth(2, bids, {});
+
+    ASSERT_EQ(count.bids, 1);
+    EXPECT_EQ(bids[0].price, 100);
+    EXPECT_EQ(bids[0].volume, 10);
+    EXPECT_EQ(bids[0].order_count, 1);
+}
+
+// L2 Feed Tests
+struct LevelUpdateRecorder : NullEventSink {
+    std::vector<LevelUpdate> updates;
+    void on_level_update(OrderType side, const Level& level) {
+        updates.push_back({level.get_price(), side, level.get_displayed_volume(),
+                           level.get_displayed_order_number()});
+    }
+};
+
+TEST(l2_feed_test, one_update_per_level_per_sweep) {
+    BasicBook<FifoMatching, LevelUpdateRecorder> book;
+
+    book.place_order(1, 1, SELL, 100, 5);
+    book.place_order(2, 1, SELL, 100, 5);
+    book.place_order(3, 1, SELL, 101, 5);
+    book.place_order(4, 1, SELL, 102, 5);
+    auto& updates = book.get_event_sink().updates;
+    updates.clear();
+
+    book.place_order(5, 2, BUY, 102, 12);
+
+    ASSERT_EQ(updates.size(), 2);
+    EXPECT_EQ(updates[0].price, 100);
+    EXPECT_EQ(updates[0].order_count, 0);
+    EXPECT_EQ(updates[1].price, 101);
+    EXPECT_EQ(updates[1].side, SELL);
+    EXPECT_EQ(updates[1].volume, 3);
+    EXPECT_EQ(updates[1].order_count, 1);
+}
+
+TEST(l2_feed_test, conflator_keeps_latest_state_per_level) {
+    BasicBook<FifoMatching, L2Conflator> book;
+
+    book.place_order(1, 1, BUY, 99, 5);
+    book.place_order(2, 1, SELL, 100, 5);
+    book.place_order(3, 1, SELL, 100, 5);
+    book.place_order(4, 2, BUY, 100, 7);
+    book.delete_order(1);
+
+    std::vector<LevelUpdate> published;
+    EXPECT_EQ(book.get_event_sink().flush([&](const LevelUpdate& u) { published.push_back(u); }), 2);
+    ASSERT_EQ(published.size(), 2);
+    EXPECT_EQ(published[0].price, 99);
+    EXPECT_EQ(published[0].side, BUY);
+    EXPECT_EQ(published[0].order_count, 0);
+    EXPECT_EQ(published[1].price, 100);
+    EXPECT_EQ(published[1].volume, 3);
+    EXPECT_EQ(published[1].order_count, 1);
+
+    book.place_order(5, 1, SELL, 100, 1);
+    EXPECT_EQ(book.get_event_sink().get_pending_count(), 1);
+}
+
+TEST(l2_feed_test, conflator_batches_stay_independent) {
+    L2Conflator conflator(4);
+    Level level(0);
+    size_t total = 0;
+    // Many small batches over ever-new prices: each flush forgets the last batch
+    for (PRICE batch = 0; batch < 5000; ++batch) {
+        for (PRICE i = 0; i < 3; ++i) {
+            level.set_price(1000 + batch * 3 + i);
+            conflator.on_level_update(BUY, level);
+            conflator.on_level_update(BUY, level);
+        }
+        level.set_price(1000 + batch * 3);
+        conflator.on_level_update(SELL, level);
+        ASSERT_EQ(conflator.get_pending_count(), 4);
+        total += conflator.flush([](const LevelUpdate&) {});
+        ASSERT_EQ(conflator.get_pending_count(), 0);
+    }
+    EXPECT_EQ(total, 5000 * 4);
+}
+
+TEST(l2_feed_test, hidden_orders_stay_off_the_feed) {
+    BasicBook<FifoMatching, L2Conflator> book;
+
+    book.place_order(1, 1, BUY, 100, 10);
+    book.place_hidden_order(2, 1, BUY, 105, 50);
+    book.place_hidden_order(3, 1, BUY, 100, 20);
+    book.delete_order(2);
+
+    std::vector<LevelUpdate> updates;
+    book.get_event_sink().flush([&](const LevelUpdate& u) { updates.push_back(u); });
+    ASSERT_EQ(updates.size(), 1);
+    EXPECT_EQ(updates[0].price, 100);
+    EXPECT_EQ(updates[0].volume, 10);
+    EXPECT_EQ(updates[0].order_count, 1);
+}
+
+// Top of Book Tests
+TEST(top_of_book_test, publishes_best_prices_after_each_message) {
+    Book book;
+    TopOfBookPublisher publisher;
+    book.attach_top_of_book(&publisher);
+
+    book.place_order(1, 1, BUY, 99, 10);
+    book.place_order(2, 1, BUY, 99, 5);
+    book.place_order(3, 2, SELL, 101, 7);
+
+    TopOfBook top = publisher.load();
+    EXPECT_EQ(top.bid_price, 99);
+    EXPECT_EQ(top.bid_volume, 15);
+    EXPECT_EQ(top.bid_orders, 2);
+    EXPECT_EQ(top.ask_price, 101);
+    EXPECT_EQ(top.ask_volume, 7);
+
+    book.place_order(4, 3, SELL, 99, 10);
+    top = publisher.load();
+    EXPECT_EQ(top.bid_volume, 5);
+    EXPECT_EQ(top.last_trade_price, 99);
+
+    book.delete_order(2);
+    top = publisher.load();
+    EXPECT_EQ(top.bid_price, 0);
+    EXPECT_EQ(top.bid_orders, 0);
+}
+
+TEST(top_of_book_test, skips_store_when_top_unchanged) {
+    Book book;
+    TopOfBookPublisher publisher;
+    book.attach_top_of_book(&publisher);
+
+    book.place_order(1, 1, BUY, 100, 10);
+    std::uint64_t version = publisher.get_version();
+    book.place_order(2, 1, BUY, 90, 10);
+
+    EXPECT_EQ(publisher.get_version(), version);
+}
+
+TEST(top_of_book_test, hidden_orders_are_not_published) {
+    Book book;
+    TopOfBookPublisher publisher;
+    book.attach_top_of_book(&publisher);
+
+    book.place_order(1, 1, BUY, 100, 10);
+    book.place_hidden_order(2, 1, BUY, 105, 50);
+    book.place_hidden_order(3, 1, BUY, 100, 20);
+
+    TopOfBook top = publisher.load();
+    EXPECT_EQ(top.bid_price, 100);
+    EXPECT_EQ(top.bid_volume, 10);
+    EXPECT_EQ(top.bid_orders, 1);
+}
+
+TEST(top_of_book_test, readers_never_see_torn_records) {
+    TopOfBookPublisher publisher;
+    constexpr std::uint64_t WRITES = 20000;
+    std::atomic<bool> done{false};
+    bool consistent = true;
+
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            TopOfBook top = publisher.load();
+            consistent &= (top.bid_volume == top.ask_volume && top.bid_orders == top.bid_volume * 3);
+            std::this_thread::yield();
+        }
+    });
+    for (std::uint64_t i = 1; i <= WRITES; ++i) {
+        TopOfBook top{};
+        top.bid_volume = i;
+        top.ask_volume = i;
+        top.bid_orders = i * 3;
+        publisher.store(top);
+        if (i % 64 == 0) std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(publisher.get_version(), WRITES);
+}
+
+// SPSC Ring Tests
+TEST(spsc_ring_test, rounds_capacity_and_reports_full) {
+    SpscRing<int> ring(5);
+
+    EXPECT_EQ(ring.capacity(), 8);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(8));
+
+    int value = -1;
+    EXPECT_TRUE(ring.try_pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.try_push(8));
+    EXPECT_EQ(ring.size(), 8);
+}
+
+TEST(spsc_ring_test, consume_drains_in_order_across_wrap) {
+    SpscRing<int> ring(4);
+    std::vector<int> seen;
+
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 3; ++i) ring.push(round * 3 + i);
+        EXPECT_EQ(ring.consume([&](const int& v) { seen.push_back(v); }, 2), 2);
+        EXPECT_EQ(ring.consume([&](const int& v) { seen.push_back(v); }), 1);
+    }
+
+    ASSERT_EQ(seen.size(), 9);
+    for (int i = 0; i < 9; ++i) EXPECT_EQ(seen[i], i);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(spsc_ring_test, producer_spins_until_consumer_catches_up) {
+    SpscRing<std::uint64_t> ring(16);
+    constexpr std::uint64_t COUNT = 100000;
+    std::uint64_t expected = 0;
+    bool in_order = true;
+
+    std::thread consumer([&] {
+        while (expected < COUNT) {
+            size_t n = ring.consume([&](const std::uint64_t& v) {
+                in_order &= (v == expected++);
+            });
+            if (n == 0) std::this_thread::yield();
+        }
+    });
+    for (std::uint64_t i = 0; i < COUNT; ++i) ring.push(i);
+    consumer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(expected, COUNT);
+}
+
+// MPSC Queue Tests
+TEST(mpsc_queue_test, stamps_sequence_and_reports_full) {
+    CommandQueue queue(4);
+    Command command{};
+
+    for (int i = 0; i < 4; ++i) {
+        command.order_id = 10 + i;
+        EXPECT_TRUE(queue.try_push(command));
+    }
+    EXPECT_FALSE(queue.try_push(command));
+
+    std::vector<Command> drained;
+    EXPECT_EQ(queue.consume([&](const Command& c) { drained.push_back(c); }, 3), 3);
+    EXPECT_TRUE(queue.try_push(command));
+    queue.consume([&](const Command& c) { drained.push_back(c); });
+
+    ASSERT_EQ(drained.size(), 5);
+    for (size_t i = 0; i < drained.size(); ++i) {
+        EXPECT_EQ(drained[i].sequence, i);
+    }
+    EXPECT_EQ(drained[3].order_id, 13);
+}
+
+TEST(mpsc_queue_test, many_producers_keep_per_producer_order) {
+    CommandQueue queue(64);
+    constexpr int PRODUCERS = 4;
+    constexpr ID PER_PRODUCER = 5000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (ID i = 0; i < PER_PRODUCER; ++i) {
+                Command command{};
+                command.agent_id = static_cast<ID>(p);
+                command.order_id = i;
+                queue.push(command);
+            }
+        });
+    }
+
+    std::vector<ID> next(PRODUCERS, 0);
+    std::uint64_t expected_sequence = 0;
+    bool ordered = true;
+    while (expected_sequence < PRODUCERS * PER_PRODUCER) {
+        size_t n = queue.consume([&](const Command& c) {
+            ordered &= (c.sequence == expected_sequence++);
+            ordered &= (c.order_id == next[c.agent_id]++);
+        }, 32);
+        if (n == 0) std::this_thread::yield();
+    }
+    for (auto& t : producers) t.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(queue.size(), 0);
+}
+
+// Execution Report Tests
+static std::vector<ExecutionReport> drain(ExecutionRing& ring) {
+    std::vector<ExecutionReport> reports;
+    ring.consume([&](const ExecutionReport& r) { reports.push_back(r); });
+    return reports;
+}
+
+TEST(execution_report_test, accept_partial_fill_and_fill) {
+    ExecutionRing ring(64);
+    BasicBook<FifoMatching, ExecutionReportSink> book(1024, ExecutionReportSink(ring));
+
+    book.place_order(1, 1, SELL, 100, 10);
+    book.place_order(2, 2, BUY, 100, 4);
+
+    auto reports = drain(ring);
+    ASSERT_EQ(reports.size(), 4);
+    EXPECT_EQ(reports[0].exec_type, EXEC_ACCEPTED);
+    EXPECT_EQ(reports[0].leaves_volume, 10);
+    EXPECT_EQ(reports[1].exec_type, EXEC_ACCEPTED);
+    EXPECT_EQ(reports[2].exec_type, EXEC_FILL);
+    EXPECT_EQ(reports[2].order_id, 2);
+    EXPECT_EQ(reports[2].contra_order_id, 1);
+    EXPECT_EQ(reports[3].exec_type, EXEC_PARTIAL_FILL);
+    EXPECT_EQ(reports[3].order_id, 1);
+    EXPECT_EQ(reports[3].last_volume, 4);
+    EXPECT_EQ(reports[3].leaves_volume, 6);
+    EXPECT_EQ(reports[3].price, 100);
+    for (size_t i = 0; i < reports.size(); ++i) {
+        EXPECT_EQ(reports[i].sequence, i + 1);
+    }
+}
+
+TEST(execution_report_test, cancel_and_reject) {
+    ExecutionRing ring(64);
+    BasicBook<FifoMatching, ExecutionReportSink> book(1024, ExecutionReportSink(ring));
+
+    book.place_order(1, 1, SELL, 100, 10);
+    book.delete_order(1);
+    book.place_order(2, 1, BUY, 100, 0);
+    book.place_order(3, 1, SELL, 105, 5);
+    book.place_post_only_order(4, 2, BUY, 105, 5);
+
+    auto reports = drain(ring);
+    ASSERT_EQ(reports.size(), 5);
+    EXPECT_EQ(reports[1].exec_type, EXEC_CANCELLED);
+    EXPECT_EQ(reports[1].last_volume, 10);
+    EXPECT_EQ(reports[1].leaves_volume, 0);
+    EXPECT_EQ(reports[1].reason, CANCEL_USER);
+    EXPECT_EQ(reports[2].exec_type, EXEC_REJECTED);
+    EXPECT_EQ(reports[2].reason, REJECT_INVALID);
+    EXPECT_EQ(reports[4].exec_type, EXEC_REJECTED);
+    EXPECT_EQ(reports[4].order_id, 4);
+    EXPECT_EQ(reports[4].reason, REJECT_WOULD_CROSS);
+}
+
+TEST(execution_report_test, iceberg_leaves_include_reserve) {
+    ExecutionRing ring(64);
+    BasicBook<FifoMatching, ExecutionReportSink> book(1024, ExecutionReportSink(ring));
+
+    book.place_iceberg_order(1, 1, SELL, 100, 10, 3);
+    book.place_order(2, 2, BUY, 100, 3);
+
+    auto reports = drain(ring);
+    ASSERT_EQ(reports.size(), 4);
+    EXPECT_EQ(reports[3].order_id, 1);
+    EXPECT_EQ(reports[3].exec_type, EXEC_PARTIAL_FILL);
+    EXPECT_EQ(reports[3].leaves_volume, 7);
+}
+
+// Engine Runner Tests
+TEST(engine_runner_test, applies_commands_in_order_and_reports) {
+    CommandRing ingress(64);
+    ExecutionRing egress(256);
+    EngineRunner runner(ingress, egress);
+    runner.start();
+
+    Command sell{};
+    sell.type = CMD_NEW;
+    sell.order_id = 1;
+    sell.agent_id = 1;
+    sell.side = SELL;
+    sell.price = 100;
+    sell.volume = 10;
+    Command buy = sell;
+    buy.order_id = 2;
+    buy.agent_id = 2;
+    buy.side = BUY;
+    buy.volume = 4;
+    Command cancel{};
+    cancel.type = CMD_CANCEL;
+    cancel.order_id = 1;
+    ingress.push(sell);
+    ingress.push(buy);
+    ingress.push(cancel);
+    runner.stop();
+
+    EXPECT_EQ(runner.get_processed(), 3);
+    EXPECT_EQ(runner.get_book().get_resting_orders_count(), 0);
+    auto reports = drain(egress);
+    ASSERT_EQ(reports.size(), 5);
+    EXPECT_EQ(reports[2].exec_type, EXEC_FILL);
+    EXPECT_EQ(reports[4].exec_type, EXEC_CANCELLED);
+    EXPECT_EQ(reports[4].last_volume, 6);
+}
+
+TEST(engine_runner_test, producer_and_runner_overlap) {
+    CommandRing ingress(16);
+    ExecutionRing egress(1 << 12);
+    EngineRunner runner(ingress, egress, -1, WAIT_BACKOFF);
+    runner.start();
+
+    for (ID id = 1; id <= 1000; ++id) {
+        Command command{};
+        command.type = CMD_NEW;
+        command.order_id = id;
+        command.agent_id = 1;
+        command.side = BUY;
+        command.price = 100 + static_cast<PRICE>(id % 10);
+        command.volume = 1;
+        ingress.push(command);
+    }
+    runner.stop();
+
+    EXPECT_EQ(runner.get_processed(), 1000);
+    EXPECT_EQ(runner.get_book().get_resting_orders_count(), 1000);
+    EXPECT_EQ(egress.size(), 1000);
+}
+
+TEST(engine_runner_test, drains_shared_mpsc_ingress) {
+    CommandQueue ingress(64);
+    ExecutionRing egress(1 << 12);
+    EngineRunner runner(ingress, egress);
+    runner.start();
+
+    std::vector<std::thread> gateways;
+    for (ID g = 0; g < 3; ++g) {
+        gateways.emplace_back([&ingress, g] {
+            for (ID i = 0; i < 200; ++i) {
+                Command command{};
+                command.type = CMD_NEW;
+                command.order_id = g * 1000 + i + 1;
+                command.agent_id = g;
+                command.side = BUY;
+                command.price = 100;
+                command.volume = 1;
+                ingress.push(command);
+            }
+        });
+    }
+    for (auto& t : gateways) t.join();
+    runner.stop();
+
+    EXPECT_EQ(runner.get_processed(), 600);
+    EXPECT_EQ(runner.get_book().get_resting_orders_count(), 600);
+}
+
+// Pipeline Tests
+struct WireOrder {
+    char side;      // 'B' or 'S'; anything else is malformed
+    PRICE price;
+    Volume volume;
+    ID order_id;
+};
+
+TEST(pipeline_test, stages_decode_filter_match_and_publish) {
+    std::vector<ExecutionReport> published;
+    auto decode = [](const WireOrder& wire, Command& command) {
+        if (wire.side != 'B' && wire.side != 'S') return false;
+        command.type = CMD_NEW;
+        command.order_id = wire.order_id;
+        command.agent_id = wire.order_id;
+        command.side = wire.side == 'B' ? BUY : SELL;
+        command.price = wire.price;
+        command.volume = wire.volume;
+        return true;
+    };
+    auto risk = [](Command& command) { return command.volume <= 100; };
+    auto publish = [&published](const ExecutionReport& report) { published.push_back(report); };
+
+    Pipeline<WireOrder, decltype(decode), decltype(risk), decltype(publish)>
+        pipeline(decode, risk, publish, 64);
+    pipeline.start();
+    pipeline.submit({'S', 100, 10, 1});
+    pipeline.submit({'X', 100, 10, 2});
+    pipeline.submit({'B', 100, 500, 3});
+    pipeline.submit({'B', 100, 4, 4});
+    pipeline.stop();
+
+    EXPECT_EQ(pipeline.get_stats(STAGE_DECODE).items, 4);
+    EXPECT_EQ(pipeline.get_stats(STAGE_DECODE).rejected, 1);
+    EXPECT_EQ(pipeline.get_stats(STAGE_RISK).rejected, 1);
+    EXPECT_EQ(pipeline.get_stats(STAGE_MATCH).items, 2);
+    // Latency runs from submit(), so it only grows along the pipeline
+    EXPECT_GT(pipeline.get_stats(STAGE_DECODE).mean_latency_ns, 0.0);
+    EXPECT_GE(pipeline.get_stats(STAGE_MATCH).mean_latency_ns, pipeline.get_stats(STAGE_DECODE).mean_latency_ns);
+    EXPECT_EQ(pipeline.get_stats(STAGE_PUBLISH).items, 4);
+    ASSERT_EQ(published.size(), 4);
+    EXPECT_EQ(published[2].exec_type, EXEC_FILL);
+    EXPECT_EQ(pipeline.get_book().get_resting_orders_count(), 1);
+}
+
+// Sharded Engine Tests
+static Command new_order(std::uint32_t symbol, ID id, OrderType side, PRICE price, Volume volume) {
+    Command command{};
+    command.type = CMD_NEW;
+    command.symbol_id = symbol;
+    command.order_id = id;
+    command.agent_id = id;
+    command.side = side;
+    command.price = price;
+    command.volume = volume;
+    return command;
+}
+
+TEST(sharded_engine_test, routes_by_symbol_and_tags_reports) {
+    ShardedEngine engine(4, 2);
+    engine.start();
+
+    EXPECT_TRUE(engine.submit(new_order(3, 1, SELL, 100, 5)));
+    EXPECT_TRUE(engine.submit(new_order(3, 2, BUY, 100, 5)));
+    EXPECT_TRUE(engine.submit(new_order(0, 1, BUY, 100, 5)));
+    EXPECT_FALSE(engine.submit(new_order(4, 1, BUY, 100, 5)));
+    engine.stop();
+
+    EXPECT_EQ(engine.get_processed(engine.get_shard_of(3)), 2);
+    EXPECT_EQ(engine.get_book(3).get_resting_orders_count(), 0);
+    EXPECT_EQ(engine.get_book(0).get_resting_orders_count(), 1);
+    auto reports = drain(engine.get_egress(engine.get_shard_of(3)));
+    ASSERT_EQ(reports.size(), 4);
+    for (const auto& r : reports) EXPECT_EQ(r.symbol_id, 3);
+}
+
+TEST(sharded_engine_test, rebalance_spreads_hot_symbols) {
+    ShardedEngine engine(4, 2);
+    engine.start();
+    ASSERT_EQ(engine.get_shard_of(0), engine.get_shard_of(2));
+
+    for (ID id = 1; id <= 50; ++id) {
+        engine.submit(new_order(0, id, BUY, 100, 1));
+        engine.submit(new_order(2, id, BUY, 100, 1));
+    }
+    engine.submit(new_order(1, 1, BUY, 100, 1));
+
+    EXPECT_EQ(engine.rebalance(), 1);
+    EXPECT_NE(engine.get_shard_of(0), engine.get_shard_of(2));
+
+    engine.submit(new_order(2, 51, SELL, 100, 1));
+    engine.stop();
+
+    EXPECT_EQ(engine.get_book(2).get_resting_orders_count(), 49);
+    // Shard 1 already held symbol 1's report; symbol 2 now reports there too
+    auto reports = drain(engine.get_egress(engine.get_shard_of(2)));
+    ASSERT_EQ(reports.size(), 4);
+    EXPECT_EQ(reports[0].symbol_id, 1);
+    EXPECT_EQ(reports[1].symbol_id, 2);
+    EXPECT_EQ(reports[1].exec_type, EXEC_ACCEPTED);
+}
+
+// Read-replica Tests
+using PrimaryBook = BasicBook<FifoMatching, BookEventSink>;
+
+// Applies everything the primary emitted and checks both books agree
+static void expect_replica_in_sync(const PrimaryBook& primary, ReplicaBook& replica, BookEventRing& ring) {
+    while (replica.poll(ring) != 0) {}
+    EXPECT_EQ(replica.get_last_sequence(), primary.get_event_sink().get_sequence());
+    EXPECT_EQ(replica.state_hash(), primary.state_hash());
+    EXPECT_EQ(replica.get_resting_orders_count(),
+              primary.get_resting_orders_count() - primary.get_pegged_orders_count());
+    EXPECT_EQ(replica.get_best_buy(), primary.get_best_buy());
+    EXPECT_EQ(replica.get_best_sell(), primary.get_best_sell());
+
+    LevelView primary_bids[8], primary_asks[8], replica_bids[8], replica_asks[8];
+    DepthCount p = primary.snapshot_depth(8, primary_bids, primary_asks);
+    DepthCount r = replica.snapshot_depth(8, replica_bids, replica_asks);
+    ASSERT_EQ(p.bids, r.bids);
+    ASSERT_EQ(p.asks, r.asks);
+    for (size_t i = 0; i < p.bids; ++i) {
+        EXPECT_EQ(primary_bids[i].volume, replica_bids[i].volume);
+        EXPECT_EQ(primary_bids[i].order_count, replica_bids[i].order_count);
+    }
+    for (size_t i = 0; i < p.asks; ++i) {
+        EXPECT_EQ(primary_asks[i].volume, replica_asks[i].volume);
+        EXPECT_EQ(primary_asks[i].order_count, replica_asks[i].order_count);
+    }
+}
+
+TEST(replica_book_test, state_hash_tracks_queue_order) {
+    Book a, b;
+    a.place_order(1, 1, BUY, 100, 10);
+    a.place_order(2, 1, BUY, 100, 10);
+    b.place_order(2, 1, BUY, 100, 10);
+    b.place_order(1, 1, BUY, 100, 10);
+    EXPECT_NE(a.state_hash(), b.state_hash());
+    b.amend_order(2, 100, 20); // size up: re-queued behind order 1
+    a.amend_order(2, 100, 20);
+    EXPECT_EQ(a.state_hash(), b.state_hash());
+}
+
+TEST(replica_book_test, matches_primary_after_every_message) {
+    BookEventRing ring(1 << 12);
+    PrimaryBook primary(1024, BookEventSink(ring));
+#if LOB_ENABLE_STP
+    primary.set_stp_mode(STP_DECREMENT);
+#endif
+    ReplicaBook replica;
+
+    std::uint64_t state = 42;
+    auto next = [&state](std::uint64_t bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (state >> 33) % bound;
+    };
+
+    ID next_id = 1;
+    for (int i = 0; i < 3000; ++i) {
+        OrderType side = next(2) ? BUY : SELL;
+        PRICE price = 95 + next(11);
+        Volume volume = 1 + next(40);
+        ID agent = 1 + next(4);
+        switch (next(8)) {
+            case 0: primary.place_iceberg_order(next_id++, agent, side, price, volume * 3, 1 + next(10)); break;
+            case 1: primary.place_hidden_order(next_id++, agent, side, price, volume); break;
+            case 2: primary.place_pegged_order(next_id++, agent, side, PEG_PRIMARY, volume); break;
+            case 3: primary.delete_order(1 + next(next_id)); break;
+            case 4: primary.amend_order(1 + next(next_id), price, next(30)); break;
+            default: primary.place_order(next_id++, agent, side, price, volume); break;
+        }
+        expect_replica_in_sync(primary, replica, ring);
+        if (HasFailure()) {
+            FAIL() << "diverged at message " << i;
+        }
+    }
+    EXPECT_GT(primary.get_event_sink().get_sequence(), 3000u);
+}
+
+TEST(replica_book_test, follows_uncross) {
+    BookEventRing ring(256);
+    PrimaryBook primary(1024, BookEventSink(ring));
+    ReplicaBook replica;
+
+    primary.set_auction_mode(true);
+    primary.place_order(1, 1, BUY, 102, 30);
+    primary.place_iceberg_order(2, 2, BUY, 101, 50, 10);
+    primary.place_order(3, 3, SELL, 99, 25);
+    primary.place_order(4, 4, SELL, 100, 40);
+    expect_replica_in_sync(primary, replica, ring);
+
+    primary.set_auction_mode(false);
+    primary.uncross();
+    expect_replica_in_sync(primary, replica, ring);
+}
+
+TEST(replica_book_test, consumes_on_another_thread) {
+    BookEventRing ring(1 << 10);
+    PrimaryBook primary(1024, BookEventSink(ring));
+    ReplicaBook replica;
+    std::atomic<bool> done{false};
+
+    std::thread follower([&] {
+        while (!done.load(std::memory_order_acquire) || !ring.empty()) {
+            if (replica.poll(ring) == 0) std::this_thread::yield();
+        }
+    });
+    for (ID id = 1; id <= 2000; ++id) {
+        primary.place_order(id, id % 3, (id % 2) ? BUY : SELL, 100 + (id % 5), 1 + id % 7);
+    }
+    done.store(true, std::memory_order_release);
+    follower.join();
+
+    EXPECT_EQ(replica.get_last_sequence(), primary.get_event_sink().get_sequence());
+    EXPECT_EQ(replica.state_hash(), primary.state_hash());
+}
+
+// Journal Tests
+static std::string journal_path(const char* name) {
+    std::string path = ::testing::TempDir() + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+TEST(journal_test, recovers_appended_prefix_and_continues) {
+    std::string path = journal_path("lob_journal_recover.bin");
+    {
+        Journal journal(path.c_str(), 128);
+        ASSERT_TRUE(journal.is_open());
+        EXPECT_EQ(journal.get_recovered(), 0);
+        for (ID id = 1; id <= 100; ++id) {
+            ASSERT_TRUE(journal.append(new_order(0, id, BUY, 100, id)));
+        }
+        EXPECT_EQ(journal.flush(), 100);
+        EXPECT_EQ(journal.get_durable(), 100);
+        EXPECT_EQ(journal.flush(), 0);
+    }
+
+    Journal journal(path.c_str(), 0); // existing file keeps its capacity
+    ASSERT_TRUE(journal.is_open());
+    EXPECT_EQ(journal.get_capacity(), 128);
+    EXPECT_EQ(journal.get_recovered(), 100);
+    ID expected = 1;
+    EXPECT_EQ(journal.replay([&](const Command& c) {
+        EXPECT_EQ(c.order_id, expected);
+        EXPECT_EQ(c.volume, expected);
+        ++expected;
+    }), 100);
+
+    for (ID id = 101; id <= 128; ++id) {
+        ASSERT_TRUE(journal.append(new_order(0, id, SELL, 100, 1)));
+    }
+    EXPECT_FALSE(journal.append(new_order(0, 129, SELL, 100, 1)));
+    EXPECT_EQ(journal.get_appended(), 128);
+    std::remove(path.c_str());
+}
+
+TEST(journal_test, group_commit_thread_makes_appends_durable) {
+    std::string path = journal_path("lob_journal_flusher.bin");
+    Journal journal(path.c_str(), 1 << 12, std::chrono::microseconds(100));
+    journal.start();
+    for (ID id = 1; id <= 1000; ++id) {
+        journal.append(new_order(0, id, BUY, 100, 1));
+    }
+    for (int i = 0; i < 10000 && journal.get_durable() != 1000; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    EXPECT_EQ(journal.get_durable(), 1000);
+    journal.stop();
+    std::remove(path.c_str());
+}
+
+TEST(journal_test, replay_rebuilds_engine_book) {
+    std::string path = journal_path("lob_journal_engine.bin");
+    CommandRing ingress(256);
+    ExecutionRing egress(1 << 12);
+    EngineRunner runner(ingress, egress);
+    {
+        Journal journal(path.c_str(), 1024);
+        journal.start();
+        runner.attach_journal(&journal);
+        runner.start();
+        for (ID id = 1; id <= 300; ++id) {
+            Command command = new_order(0, id, (id % 3) ? BUY : SELL, 98 + id % 5, 1 + id % 9);
+            if (id % 7 == 0) {
+                command.type = CMD_CANCEL;
+                command.order_id = id - 3;
+            }
+            ingress.push(command);
+            if (id % 32 == 0) drain(egress);
+        }
+        runner.stop();
+        runner.attach_journal(static_cast<Journal*>(nullptr));
+        journal.stop();
+        EXPECT_EQ(journal.get_durable(), 300);
+    }
+
+    ExecutionRing replay_egress(1 << 12);
+    RunnerBook rebuilt(1024, ExecutionReportSink(replay_egress));
+    Journal journal(path.c_str(), 0);
+    size_t replayed = journal.replay([&](const Command& c) {
+        apply_command(rebuilt, c);
+        if (replay_egress.size() > 1024) drain(replay_egress);
+    });
+    EXPECT_EQ(replayed, 300);
+    EXPECT_EQ(rebuilt.state_hash(), runner.get_book().state_hash());
+    EXPECT_EQ(rebuilt.get_resting_orders_count(), runner.get_book().get_resting_orders_count());
+    std::remove(path.c_str());
+}
+
+TEST(journal_test, full_journal_stops_runner_before_applying) {
+    std::string path = journal_path("lob_journal_full.bin");
+    Journal journal(path.c_str(), 8);
+    ASSERT_TRUE(journal.is_open());
+    CommandRing ingress(64);
+    ExecutionRing egress(256);
+    EngineRunner runner(ingress, egress);
+    runner.attach_journal(&journal);
+    for (ID id = 1; id <= 20; ++id) {
+        ingress.push(new_order(0, id, BUY, 100, 1));
+    }
+    runner.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (runner.is_running() && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+    runner.stop();
+
+    // Exactly what the journal holds was applied; the rest is still queued
+    EXPECT_TRUE(runner.is_journal_full());
+    EXPECT_EQ(journal.get_appended(), 8);
+    EXPECT_EQ(runner.get_processed(), 8);
+    EXPECT_EQ(runner.get_book().get_resting_orders_count(), 8);
+    EXPECT_EQ(ingress.size(), 12);
+    Command next{};
+    ASSERT_TRUE(ingress.try_pop(next));
+    EXPECT_EQ(next.order_id, 9);
+    std::remove(path.c_str());
+}
+
+TEST(journal_test, restarts_on_fresh_journal_without_stop) {
+    std::string path = journal_path("lob_journal_full_first.bin");
+    std::string next_path = journal_path("lob_journal_full_next.bin");
+    Journal journal(path.c_str(), 8);
+    Journal next_journal(next_path.c_str(), 64);
+    ASSERT_TRUE(journal.is_open());
+    ASSERT_TRUE(next_journal.is_open());
+    CommandRing ingress(64);
+    ExecutionRing egress(256);
+    EngineRunner runner(ingress, egress);
+    runner.attach_journal(&journal);
+    for (ID id = 1; id <= 20; ++id) {
+        ingress.push(new_order(0, id, BUY, 100, 1));
+    }
+    runner.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (runner.is_running() && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+    ASSERT_TRUE(runner.is_journal_full());
+
+    // The runner stopped itself: carry on with a fresh journal, no stop() in between
+    EXPECT_TRUE(runner.attach_journal(&next_journal));
+    EXPECT_FALSE(runner.is_journal_full());
+    runner.start();
+    while (runner.get_processed() < 20 && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+    runner.stop();
+
+    EXPECT_FALSE(runner.is_journal_full());
+    EXPECT_EQ(runner.get_processed(), 20);
+    EXPECT_EQ(next_journal.get_appended(), 12);
+    EXPECT_EQ(runner.get_book().get_resting_orders_count(), 20);
+    EXPECT_TRUE(ingress.empty());
+    std::remove(path.c_str());
+    std::remove(next_path.c_str());
+}
+
+// Snapshot Tests
+static void build_snapshot_book(Book& book) {
+    book.place_order(1, 1, BUY, 99, 10);
+    book.place_order(2, 2, BUY, 99, 20);
+    book.place_order(3, 3, BUY, 97, 5, 500);           // good-till-time
+    book.place_iceberg_order(4, 4, SELL, 101, 50, 10);
+    book.place_order(5, 5, BUY, 101, 14);              // eats the tip, iceberg replenishes
+    book.place_hidden_order(6, 6, SELL, 102, 30);
+    book.place_order(7, 7, SELL, 103, 8);
+    book.place_pegged_order(8, 8, BUY, PEG_PRIMARY, 6);
+    book.place_stop_order(9, 9, SELL, 95, 4);
+    book.place_stop_limit_order(10, 10, BUY, 104, 105, 3);
+    book.advance_time(100);
+}
+
+TEST(snapshot_test, round_trip_preserves_queues_and_behaviour) {
+    std::string path = journal_path("lob_snapshot_roundtrip.bin");
+    Book original;
+    build_snapshot_book(original);
+    ASSERT_TRUE(original.save_snapshot(path.c_str(), 77));
+
+    Book restored;
+    std::uint64_t journal_position = 0;
+    ASSERT_TRUE(restored.load_snapshot(path.c_str(), &journal_position));
+    EXPECT_EQ(journal_position, 77);
+    EXPECT_EQ(restored.state_hash(), original.state_hash());
+    EXPECT_EQ(restored.get_resting_orders_count(), original.get_resting_orders_count());
+    EXPECT_EQ(restored.get_pending_stops_count(), 2);
+    EXPECT_EQ(restored.get_pegged_orders_count(), 1);
+    EXPECT_EQ(restored.get_timed_orders_count(), 1);
+    EXPECT_EQ(restored.get_time(), 100);
+    EXPECT_EQ(restored.get_last_trade_price(), original.get_last_trade_price());
+
+    // Same follow-up flow, same trades: sweeps the iceberg, hidden order and a stop
+    auto follow_up = [](Book& book) {
+        std::vector<Trade> trades;
+        auto take = [&trades](const Trades& t) { trades.insert(trades.end(), t.begin(), t.end()); };
+        take(book.place_order(20, 20, BUY, 104, 100));
+        take(book.place_order(21, 21, SELL, 90, 60));
+        book.advance_time(1000);
+        return trades;
+    };
+    std::vector<Trade> expected = follow_up(original);
+    std::vector<Trade> actual = follow_up(restored);
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].get_matched_order(), expected[i].get_matched_order());
+        EXPECT_EQ(actual[i].get_trade_price(), expected[i].get_trade_price());
+        EXPECT_EQ(actual[i].get_trade_volume(), expected[i].get_trade_volume());
+    }
+    EXPECT_EQ(restored.state_hash(), original.state_hash());
+    EXPECT_EQ(restored.get_timed_orders_count(), original.get_timed_orders_count());
+    std::remove(path.c_str());
+}
+
+TEST(snapshot_test, restart_is_snapshot_plus_journal_tail) {
+    std::string snapshot = journal_path("lob_snapshot_restart.bin");
+    std::string journal_file = journal_path("lob_snapshot_restart.journal");
+    ExecutionRing egress(1 << 14);
+    RunnerBook live(1024, ExecutionReportSink(egress));
+    {
+        Journal journal(journal_file.c_str(), 1024);
+        for (ID id = 1; id <= 600; ++id) {
+            Command command = new_order(0, id, (id % 2) ? BUY : SELL, 95 + id % 11, 1 + id % 13);
+            if (id % 5 == 0) {
+                command.type = CMD_CANCEL;
+                command.order_id = id - 2;
+            }
+            journal.append(command);
+            apply_command(live, command);
+            if (id == 400) {
+                ASSERT_TRUE(live.save_snapshot(snapshot.c_str(), journal.get_appended()));
+            }
+        }
+        drain(egress);
+    }
+
+    ExecutionRing replay_egress(1 << 14);
+    RunnerBook restarted(1024, ExecutionReportSink(replay_egress));
+    std::uint64_t position = 0;
+    ASSERT_TRUE(restarted.load_snapshot(snapshot.c_str(), &position));
+    EXPECT_EQ(position, 400);
+    Journal journal(journal_file.c_str(), 0);
+    EXPECT_EQ(journal.replay([&](const Command& c) { apply_command(restarted, c); }, position), 200);
+    EXPECT_EQ(restarted.state_hash(), live.state_hash());
+    std::remove(snapshot.c_str());
+    std::remove(journal_file.c_str());
+}
+
+TEST(snapshot_test, load_requires_empty_book_and_valid_file) {
+    std::string path = journal_path("lob_snapshot_invalid.bin");
+    Book book;
+    book.place_order(1, 1, BUY, 100, 10);
+    ASSERT_TRUE(book.save_snapshot(path.c_str()));
+    EXPECT_FALSE(book.load_snapshot(path.c_str()));
+
+    Book empty;
+    EXPECT_FALSE(empty.load_snapshot("/nonexistent/lob_snapshot.bin"));
+    {
+        std::FILE* f = std::fopen(path.c_str(), "r+b");
+        ASSERT_NE(f, nullptr);
+        std::fseek(f, 0, SEEK_END);
+        std::fputc(0, f); // trailing garbage breaks the framing
+        std::fclose(f);
+    }
+    EXPECT_FALSE(empty.load_snapshot(path.c_str()));
+    EXPECT_EQ(empty.get_resting_orders_count(), 0);
+    std::remove(path.c_str());
+}
+
+TEST(snapshot_test, load_refuses_snapshot_older_than_book_clock) {
+    std::string path = journal_path("lob_snapshot_clock.bin");
+    Book original;
+    build_snapshot_book(original);                      // clock 100, order 3 expires at 500
+    ASSERT_TRUE(original.save_snapshot(path.c_str()));
+
+    // Traded and emptied, with its clock already past the snapshot's: order 3
+    // would be due at or before now and never fire
+    Book used;
+    used.place_order(50, 1, BUY, 99, 5);
+    used.place_order(51, 2, SELL, 99, 5);
+    used.advance_time(500);
+    ASSERT_EQ(used.get_resting_orders_count(), 0);
+    EXPECT_FALSE(used.load_snapshot(path.c_str()));
+    EXPECT_EQ(used.get_resting_orders_count(), 0);
+    EXPECT_EQ(used.get_timed_orders_count(), 0);
+    EXPECT_EQ(used.get_time(), 500);
+
+    // A clock at or before the snapshot's is fine
+    Book behind;
+    behind.advance_time(100);
+    ASSERT_TRUE(behind.load_snapshot(path.c_str()));
+    EXPECT_EQ(behind.state_hash(), original.state_hash());
+    EXPECT_EQ(behind.get_timed_orders_count(), 1);
+    EXPECT_EQ(behind.advance_time(500), 1);
+    std::remove(path.c_str());
+}
+
+// File offset of the first SnapshotLevel of `queue` holding orders (0 if none)
+static size_t snapshot_level_offset(const std::vector<unsigned char>& bytes, SnapshotQueue queue, size_t skip = 0) {
+    size_t offset = sizeof(SnapshotHeader);
+    while (offset + sizeof(SnapshotLevel) <= bytes.size()) {
+        SnapshotLevel level;
+        std::memcpy(&level, bytes.data() + offset, sizeof(level));
+        if (level.queue == queue && level.order_count != 0 && skip-- == 0) return offset;
+        offset += sizeof(level) + level.order_count * sizeof(SnapshotOrder);
+    }
+    return 0;
+}
+
+TEST(snapshot_test, rejects_inconsistent_records_without_touching_book) {
+    std::string path = journal_path("lob_snapshot_corrupt.bin");
+    Book original;
+    build_snapshot_book(original);
+    ASSERT_TRUE(original.save_snapshot(path.c_str()));
+    std::vector<unsigned char> good;
+    ASSERT_TRUE(read_file(path.c_str(), good));
+
+    size_t bid = snapshot_level_offset(good, SNAP_BID_LEVEL);
+    size_t second_bid = snapshot_level_offset(good, SNAP_BID_LEVEL, 1);
+    size_t ask = snapshot_level_offset(good, SNAP_ASK_LEVEL);
+    size_t peg = snapshot_level_offset(good, SNAP_PEG_QUEUE);
+    size_t buy_stop = snapshot_level_offset(good, SNAP_BUY_STOP);
+    ASSERT_TRUE(bid && second_bid && ask && peg && buy_stop);
+
+    auto edit_level = [](std::vector<unsigned char>& bytes, size_t offset, auto&& fn) {
+        SnapshotLevel level;
+        std::memcpy(&level, bytes.data() + offset, sizeof(level));
+        fn(level);
+        std::memcpy(bytes.data() + offset, &level, sizeof(level));
+    };
+    auto edit_order = [](std::vector<unsigned char>& bytes, size_t level_offset, auto&& fn) {
+        SnapshotOrder order;
+        size_t offset = level_offset + sizeof(SnapshotLevel);
+        std::memcpy(&order, bytes.data() + offset, sizeof(order));
+        fn(order);
+        std::memcpy(bytes.data() + offset, &order, sizeof(order));
+    };
+    std::vector<std::function<void(std::vector<unsigned char>&)>> corruptions = {
+        // A sell order on a bid level
+        [&](auto& b) { edit_order(b, bid, [](SnapshotOrder& o) { o.side = SELL; }); },
+        // Out-of-range enums
+        [&](auto& b) { edit_order(b, bid, [](SnapshotOrder& o) { o.status = 9; }); },
+        [&](auto& b) { edit_order(b, peg, [](SnapshotOrder& o) { o.peg_type = 7; }); },
+        // Order price differs from its level
+        [&](auto& b) { edit_order(b, ask, [](SnapshotOrder& o) { o.price += 1; }); },
+        // Duplicate order id across levels
+        [&](auto& b) { edit_order(b, ask, [](SnapshotOrder& o) { o.order_id = 1; }); },
+        // Bid levels out of order
+        [&](auto& b) {
+            edit_level(b, second_bid, [](SnapshotLevel& l) { l.price = 100; });
+            size_t count = 0;
+            std::memcpy(&count, b.data() + second_bid, sizeof(count));
+            for (size_t i = 0; i < count; ++i) {
+                SnapshotOrder o;
+                size_t at = second_bid + sizeof(SnapshotLevel) + i * sizeof(o);
+                std::memcpy(&o, b.data() + at, sizeof(o));
+                o.price = 100;
+                std::memcpy(b.data() + at, &o, sizeof(o));
+            }
+        },
+        // Crossed book outside an auction
+        [&](auto& b) {
+            edit_level(b, ask, [](SnapshotLevel& l) { l.price = 99; });
+            edit_order(b, ask, [](SnapshotOrder& o) { o.price = 99; });
+        },
+        // Stop trigger that does not match its trigger level
+        [&](auto& b) { edit_order(b, buy_stop, [](SnapshotOrder& o) { o.trigger_price += 1; }); },
+        // A pending stop filed as a resting order
+        [&](auto& b) { edit_order(b, bid, [](SnapshotOrder& o) { o.status = PENDING; }); },
+    };
+
+    Book empty;
+    for (size_t i = 0; i < corruptions.size(); ++i) {
+        std::vector<unsigned char> bytes = good;
+        corruptions[i](bytes);
+        ASSERT_TRUE(write_file_atomically(path.c_str(), bytes.data(), bytes.size()));
+        Book book;
+        EXPECT_FALSE(book.load_snapshot(path.c_str())) << "corruption " << i;
+        EXPECT_EQ(book.get_resting_orders_count(), 0);
+        EXPECT_EQ(book.get_pending_stops_count(), 0);
+        EXPECT_EQ(book.state_hash(), empty.state_hash());
+    }
+
+    // The untouched file still loads
+    ASSERT_TRUE(write_file_atomically(path.c_str(), good.data(), good.size()));
+    Book restored;
+    EXPECT_TRUE(restored.load_snapshot(path.c_str()));
+    EXPECT_EQ(restored.state_hash(), original.state_hash());
+    std::remove(path.c_str());
+}
+
+// Replay Tests
+TEST(replay_test, event_hash_is_deterministic_and_order_sensitive) {
+    std::vector<Command> commands;
+    for (ID id = 1; id <= 200; ++id) {
+        commands.push_back(new_order(0, id, (id % 2) ? BUY : SELL, 98 + id % 5, 1 + id % 7));
+    }
+    auto run = [](const std::vector<Command>& input) {
+        BasicBook<FifoMatching, EventHashSink> book;
+        for (const Command& c : input) apply_command(book, c);
+        return book.get_event_sink().get_hash();
+    };
+    EXPECT_EQ(run(commands), run(commands));
+
+    std::vector<Command> reordered = commands;
+    std::swap(reordered[10], reordered[11]); // a buy and a sell at different prices
+    EXPECT_NE(run(commands), run(reordered));
+}
+
+TEST(replay_test, read_journal_returns_valid_prefix) {
+    std::string path = journal_path("lob_replay_read.bin");
+    {
+        Journal journal(path.c_str(), 64);
+        for (ID id = 1; id <= 40; ++id) journal.append(new_order(0, id, BUY, 100, id));
+    }
+    std::vector<Command> commands;
+    ASSERT_TRUE(read_journal(path.c_str(), commands));
+    ASSERT_EQ(commands.size(), 40);
+    EXPECT_EQ(commands.back().volume, 40);
+    EXPECT_FALSE(read_journal("/nonexistent/lob.journal", commands));
+    std::remove(path.c_str());
+}
+
+// io_uring Persistence Tests
+TEST(uring_log_test, writes_segments_in_order_and_syncs) {
+    std::string path = journal_path("lob_uring_log.bin");
+    std::vector<unsigned char> bytes;
+    {
+        UringLog log(path.c_str(), 4096, 4);
+        if (!log.is_open()) GTEST_SKIP() << "io_uring unavailable";
+
+        for (std::uint64_t i = 0; i < 10000; ++i) {
+            while (!log.append(i)) {
+                log.poll();
+                std::this_thread::yield();
+            }
+        }
+        EXPECT_EQ(log.get_appended_bytes(), 80000);
+        EXPECT_LE(log.get_posted_bytes(), 80000);
+        log.drain();
+        EXPECT_EQ(log.get_error(), 0);
+        EXPECT_EQ(log.get_completed_bytes(), 80000);
+        EXPECT_EQ(log.get_durable_bytes(), 80000);
+        EXPECT_EQ(log.get_in_flight(), 0);
+    }
+    ASSERT_TRUE(read_file(path.c_str(), bytes));
+    ASSERT_EQ(bytes.size(), 80000);
+    for (std::uint64_t i = 0; i < 10000; i += 999) {
+        std::uint64_t value;
+        std::memcpy(&value, bytes.data() + i * sizeof(value), sizeof(value));
+        EXPECT_EQ(value, i);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(uring_log_test, resubmits_short_write_tail) {
+    std::string path = journal_path("lob_uring_short.bin");
+    // The file size limit cuts the second segment's write short: its tail is
+    // resubmitted at the advanced offset and then fails with EFBIG
+    rlimit saved;
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &saved), 0);
+    void (*saved_handler)(int) = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = saved;
+    limited.rlim_cur = 4096 + 1000;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limited), 0);
+    {
+        UringLog log(path.c_str(), 4096, 4);
+        if (log.is_open()) {
+            for (std::uint64_t i = 0; i < 2 * 4096 / sizeof(i); ++i) {
+                ASSERT_TRUE(log.append(i));
+            }
+            log.drain();
+            EXPECT_EQ(log.get_error(), EFBIG);
+            EXPECT_EQ(log.get_completed_bytes(), 4096);
+            EXPECT_EQ(log.get_durable_bytes(), 4096 + 1000);
+            EXPECT_EQ(log.get_in_flight(), 0);
+        }
+    }
+    setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, saved_handler);
+    std::error_code ec;
+    if (std::filesystem::exists(path, ec)) {
+        EXPECT_EQ(std::filesystem::file_size(path), 4096 + 1000);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(uring_log_test, runner_takes_one_journal) {
+    std::string path = journal_path("lob_uring_one_journal.bin");
+    std::string other = journal_path("lob_uring_other_journal.bin");
+    CommandRing ingress(16);
+    ExecutionRing egress(64);
+    EngineRunner runner(ingress, egress);
+    UringJournal uring(path.c_str(), 4096, 2);
+    if (!uring.is_open()) GTEST_SKIP() << "io_uring unavailable";
+    Journal journal(other.c_str(), 16);
+    EXPECT_TRUE(runner.attach_journal(&uring));
+    EXPECT_FALSE(runner.attach_journal(&journal));
+    EXPECT_TRUE(runner.attach_journal(static_cast<UringJournal*>(nullptr)));
+    EXPECT_TRUE(runner.attach_journal(&journal));
+    EXPECT_FALSE(runner.attach_journal(&uring));
+    std::remove(path.c_str());
+    std::remove(other.c_str());
+}
+
+// A runner halted by a UringJournal with every segment in flight carries on once restarted
+static void restart_on_backpressure(EngineRunner& runner, UringJournal& journal) {
+    if (!runner.is_running() && runner.is_journal_full()) {
+        runner.attach_journal(&journal);
+        runner.start();
+    }
+}
+
+TEST(uring_log_test, runner_refuses_journal_that_is_not_open) {
+    std::string path = journal_path("lob_uring_tiny.bin");
+    CommandRing ingress(16);
+    ExecutionRing egress(64);
+    EngineRunner runner(ingress, egress);
+    // A segment smaller than one record can never take an append
+    UringJournal tiny(path.c_str(), sizeof(JournalRecord) / 2, 2);
+    EXPECT_FALSE(tiny.is_open());
+    EXPECT_FALSE(runner.attach_journal(&tiny));
+    std::remove(path.c_str());
+}
+
+TEST(uring_log_test, backpressure_stops_runner_instead_of_waiting) {
+    std::string path = journal_path("lob_uring_backpressure.bin");
+    constexpr ID COUNT = 3000;
+    CommandRing ingress(COUNT);
+    ExecutionRing egress(1 << 14);
+    EngineRunner runner(ingress, egress);
+    std::uint64_t appended = 0;
+    {
+        // One record per segment and a single segment: the next command finds
+        // it in flight unless the write has already completed
+        UringJournal journal(path.c_str(), sizeof(JournalRecord), 1);
+        if (!journal.is_open()) GTEST_SKIP() << "io_uring unavailable";
+        ASSERT_TRUE(runner.attach_journal(&journal));
+        for (ID id = 1; id <= COUNT; ++id) {
+            ingress.push(new_order(0, id, (id % 2) ? BUY : SELL, 97 + id % 7, 1 + id % 11));
+        }
+        runner.start();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (runner.get_processed() < COUNT && std::chrono::steady_clock::now() < deadline) {
+            drain(egress);
+            if (!runner.is_running()) {
+                // Stopped before the command it had no room for: nothing was lost
+                ASSERT_TRUE(runner.is_journal_full());
+                EXPECT_EQ(journal.get_appended(), runner.get_processed());
+                EXPECT_EQ(ingress.size(), COUNT - runner.get_processed());
+                restart_on_backpressure(runner, journal);
+            }
+            std::this_thread::yield();
+        }
+        runner.stop();
+        appended = journal.get_appended();
+        EXPECT_EQ(journal.get_log().get_error(), 0);
+    }
+    EXPECT_EQ(runner.get_processed(), COUNT);
+    EXPECT_EQ(appended, COUNT);
+
+    std::vector<Command> commands;
+    ASSERT_TRUE(read_journal(path.c_str(), commands));
+    ASSERT_EQ(commands.size(), COUNT);
+    ExecutionRing replay_egress(1 << 15);
+    RunnerBook rebuilt(4096, ExecutionReportSink(replay_egress));
+    for (const Command& c : commands) apply_command(rebuilt, c);
+    EXPECT_EQ(rebuilt.state_hash(), runner.get_book().state_hash());
+    std::remove(path.c_str());
+}
+
+TEST(uring_log_test, engine_journal_replays_to_same_book) {
+    std::string path = journal_path("lob_uring_journal.bin");
+    CommandRing ingress(256);
+    ExecutionRing egress(1 << 12);
+    EngineRunner runner(ingress, egress);
+    {
+        UringJournal journal(path.c_str(), 4096, 4);
+        if (!journal.is_open()) GTEST_SKIP() << "io_uring unavailable";
+        runner.attach_journal(&journal);
+        runner.start();
+        for (ID id = 1; id <= 500; ++id) {
+            Command command = new_order(0, id, (id % 2) ? BUY : SELL, 97 + id % 7, 1 + id % 11);
+            if (id % 6 == 0) {
+                command.type = CMD_CANCEL;
+                command.order_id = id - 4;
+            }
+            while (!ingress.try_push(command)) {
+                restart_on_backpressure(runner, journal);
+                drain(egress);
+            }
+            if (id % 32 == 0) drain(egress);
+        }
+        while (runner.get_processed() < 500) {
+            restart_on_backpressure(runner, journal);
+            drain(egress);
+            std::this_thread::yield();
+        }
+        runner.stop();
+        EXPECT_EQ(journal.get_appended(), 500);
+        EXPECT_EQ(journal.get_log().get_error(), 0);
+        EXPECT_EQ(journal.get_log().get_durable_bytes(), 64 + 500 * 64);
+    }
+
+    std::vector<Command> commands;
+    ASSERT_TRUE(read_journal(path.c_str(), commands));
+    ASSERT_EQ(commands.size(), 500);
+    ExecutionRing replay_egress(1 << 14);
+    RunnerBook rebuilt(1024, ExecutionReportSink(replay_egress));
+    for (const Command& c : commands) apply_command(rebuilt, c);
+    EXPECT_EQ(rebuilt.state_hash(), runner.get_book().state_hash());
+    std::remove(path.c_str());
+}
+
+TEST(uring_log_test, event_log_persists_every_report_in_sequence) {
+    std::string path = journal_path("lob_uring_events.bin");
+    CommandRing ingress(256);
+    ExecutionRing egress(256);
+    EngineRunner runner(ingress, egress);
+    std::uint64_t published = 0;
+    {
+        // Two small segments, so the consumer regularly finds both in flight
+        UringEventLog events(path.c_str(), 4096, 2);
+        if (!events.is_open()) GTEST_SKIP() << "io_uring unavailable";
+
+        std::atomic<bool> done{false};
+        std::thread consumer([&] {
+            while (!done.load(std::memory_order_acquire) || !egress.empty()) {
+                if (events.consume(egress) == 0) std::this_thread::yield();
+            }
+            events.get_log().drain();
+        });
+        runner.start();
+        for (ID id = 1; id <= 2000; ++id) {
+            ingress.push(new_order(0, id, (id % 2) ? BUY : SELL, 97 + id % 7, 1 + id % 11));
+        }
+        runner.stop();
+        done.store(true, std::memory_order_release);
+        consumer.join();
+
+        published = events.get_appended();
+        EXPECT_GT(published, 2000);
+        EXPECT_EQ(events.get_log().get_error(), 0);
+        EXPECT_EQ(events.get_log().get_durable_bytes(), 64 + published * 64);
+    }
+
+    std::vector<ExecutionReport> reports;
+    ASSERT_TRUE(read_event_log(path.c_str(), reports));
+    ASSERT_EQ(reports.size(), published);
+    for (size_t i = 0; i < reports.size(); ++i) {
+        ASSERT_EQ(reports[i].sequence, i + 1);
+    }
+    EXPECT_EQ(reports.front().order_id, 1);
+    EXPECT_EQ(reports.front().exec_type, EXEC_ACCEPTED);
+
+    // A command journal is not an event log
+    std::string other = journal_path("lob_uring_not_events.bin");
+    { Journal journal(other.c_str(), 4); }
+    EXPECT_FALSE(read_event_log(other.c_str(), reports));
+    std::remove(path.c_str());
+    std::remove(other.c_str());
+}
+
+// Compact Journal Tests
+static std::vector<Command> compact_flow(size_t count) {
+    std::mt19937_64 rng(3);
+    std::vector<Command> commands;
+    ID next_id = 1000000;
+    Timestamp now = 1'700'000'000'000'000'000ULL;
+    for (size_t i = 0; i < count; ++i) {
+        Command c{};
+        unsigned roll = rng() % 10;
+        c.type = roll < 7 ? CMD_NEW : (roll < 9 ? CMD_CANCEL : CMD_AMEND);
+        c.order_id = (c.type == CMD_NEW) ? next_id++ : next_id - 1 - rng() % 500;
+        c.side = (rng() & 1) ? BUY : SELL;
+        if (c.type != CMD_CANCEL) {
+            c.price = static_cast<PRICE>(9990 + rng() % 21);
+            c.volume = 1 + rng() % 1000;
+        }
+        if (c.type == CMD_NEW) c.agent_id = 1 + rng() % 50;
+        c.symbol_id = (i % 100 < 90) ? 7 : static_cast<std::uint32_t>(rng() % 20);
+        now += rng() % 3000;
+        c.timestamp = now;
+        commands.push_back(c);
+    }
+    return commands;
+}
+
+static void expect_same_command(const Command& a, const Command& b) {
+    EXPECT_EQ(a.type, b.type);
+    EXPECT_EQ(a.order_id, b.order_id);
+    EXPECT_EQ(a.agent_id, b.agent_id);
+    EXPECT_EQ(a.side, b.side);
+    EXPECT_EQ(a.price, b.price);
+    EXPECT_EQ(a.volume, b.volume);
+    EXPECT_EQ(a.symbol_id, b.symbol_id);
+    EXPECT_EQ(a.timestamp, b.timestamp);
+}
+
+TEST(compact_journal_test, round_trips_and_stays_compact) {
+    std::string path = journal_path("lob_compact_roundtrip.bin");
+    std::vector<Command> commands = compact_flow(20000);
+    {
+        CompactJournalWriter writer(path.c_str());
+        ASSERT_TRUE(writer.is_open());
+        for (const Command& c : commands) ASSERT_TRUE(writer.append(c));
+        ASSERT_TRUE(writer.close());
+    }
+
+    CompactJournalReader reader(path.c_str());
+    ASSERT_TRUE(reader.is_open());
+    ASSERT_EQ(reader.get_record_count(), commands.size());
+    // 64-byte Command records, about a tenth of that encoded
+    EXPECT_LT(reader.get_file_bytes(), commands.size() * 12);
+
+    size_t i = 0;
+    EXPECT_EQ(reader.replay([&](const Command& c) { expect_same_command(c, commands[i++]); }), commands.size());
+    std::remove(path.c_str());
+}
+
+TEST(compact_journal_test, seeks_through_block_index) {
+    std::string path = journal_path("lob_compact_seek.bin");
+    std::vector<Command> commands = compact_flow(5000);
+    {
+        CompactJournalWriter writer(path.c_str(), 256);
+        for (const Command& c : commands) writer.append(c);
+    }
+    CompactJournalReader reader(path.c_str());
+    ASSERT_TRUE(reader.is_open());
+    EXPECT_GT(reader.get_block_count(), 50);
+
+    for (std::uint64_t from : {0ULL, 1ULL, 2500ULL, 4999ULL, 5000ULL}) {
+        std::uint64_t next = from;
+        size_t delivered = reader.replay([&](const Command& c) { expect_same_command(c, commands[next++]); }, from);
+        EXPECT_EQ(delivered, commands.size() - from);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(compact_journal_test, recovers_whole_blocks_without_footer) {
+    std::string path = journal_path("lob_compact_torn.bin");
+    std::vector<Command> commands = compact_flow(3000);
+    {
+        CompactJournalWriter writer(path.c_str(), 1024);
+        for (const Command& c : commands) writer.append(c);
+    }
+    // Tear the file inside the last blocks: footer and index are gone
+    std::uintmax_t size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 1500);
+
+    CompactJournalReader reader(path.c_str());
+    ASSERT_TRUE(reader.is_open());
+    EXPECT_GT(reader.get_record_count(), 2000);
+    EXPECT_LT(reader.get_record_count(), commands.size());
+    size_t i = 0;
+    EXPECT_EQ(reader.replay([&](const Command& c) { expect_same_command(c, commands[i++]); }),
+              reader.get_record_count());
+    std::remove(path.c_str());
+}
+
+TEST(compact_journal_test, rejects_index_of_overlong_block) {
+    std::string path = journal_path("lob_compact_overlong.bin");
+    std::vector<Command> commands = compact_flow(3000);
+    {
+        CompactJournalWriter writer(path.c_str(), 1024);
+        for (const Command& c : commands) writer.append(c);
+    }
+    std::vector<unsigned char> bytes;
+    ASSERT_TRUE(read_file(path.c_str(), bytes));
+
+    // Footer intact, but the last indexed block claims a payload past the index
+    CompactFooter footer;
+    std::memcpy(&footer, bytes.data() + bytes.size() - sizeof(footer), sizeof(footer));
+    CompactIndexEntry last;
+    std::memcpy(&last, bytes.data() + footer.index_offset + (footer.block_count - 1) * sizeof(last), sizeof(last));
+    CompactBlockHeader header;
+    std::memcpy(&header, bytes.data() + last.offset, sizeof(header));
+    header.payload_bytes = 1u << 30;
+    std::memcpy(bytes.data() + last.offset, &header, sizeof(header));
+    ASSERT_TRUE(write_file_atomically(path.c_str(), bytes.data(), bytes.size()));
+
+    // Falls back to the block scan, which stops before the damaged block
+    CompactJournalReader reader(path.c_str());
+    ASSERT_TRUE(reader.is_open());
+    EXPECT_EQ(reader.get_record_count(), last.first_record);
+    size_t i = 0;
+    EXPECT_EQ(reader.replay([&](const Command& c) { expect_same_command(c, commands[i++]); }),
+              last.first_record);
+    std::remove(path.c_str());
+}
+
+TEST(compact_journal_test, rejects_footer_that_wraps_or_miscounts) {
+    std::string path = journal_path("lob_compact_footer.bin");
+    std::vector<Command> commands = compact_flow(3000);
+    {
+        CompactJournalWriter writer(path.c_str(), 1024);
+        for (const Command& c : commands) writer.append(c);
+    }
+    std::vector<unsigned char> original;
+    ASSERT_TRUE(read_file(path.c_str(), original));
+    CompactFooter good;
+    std::memcpy(&good, original.data() + original.size() - sizeof(good), sizeof(good));
+
+    CompactFooter wrapping = good;   // index_offset + block_count * 16 + 32 wraps to the file size
+    wrapping.index_offset = original.size() - sizeof(CompactFooter);
+    wrapping.block_count = 1ULL << 60;
+    CompactFooter miscounted = good;
+    miscounted.record_count += 1;
+
+    for (const CompactFooter& footer : {wrapping, miscounted}) {
+        std::vector<unsigned char> bytes = original;
+        std::memcpy(bytes.data() + bytes.size() - sizeof(footer), &footer, sizeof(footer));
+        ASSERT_TRUE(write_file_atomically(path.c_str(), bytes.data(), bytes.size()));
+
+        // The footer is ignored and the block scan recovers every record
+        CompactJournalReader reader(path.c_str());
+        ASSERT_TRUE(reader.is_open());
+        EXPECT_EQ(reader.get_record_count(), commands.size());
+        size_t i = 0;
+        EXPECT_EQ(reader.replay([&](const Command& c) { expect_same_command(c, commands[i++]); }),
+                  commands.size());
+    }
+    std::remove(path.c_str());
+}
+
+// Hot-Standby Tests
+TEST(standby_test, follower_mirrors_primary_within_ring) {
+    const char* name = "/lob_test_standby_mirror";
+    std::vector<Command> commands = compact_flow(20000);
+    StandbyPublisher publisher(name, 256);
+    ASSERT_TRUE(publisher.is_open());
+    StandbyFollower follower(name);
+    ASSERT_TRUE(follower.is_open());
+    EXPECT_FALSE(StandbyFollower(name).is_open());   // one follower per region
+
+    Book follower_book(commands.size());
+    bool promoted = true;
+    std::thread standby([&] { promoted = follower.follow(follower_book, std::chrono::seconds(5)); });
+
+    Book primary(commands.size());
+    std::uint64_t max_lag = 0;
+    for (const Command& c : commands) {
+        ASSERT_TRUE(publisher.publish(c));
+        apply_command(primary, c);
+        publisher.heartbeat();
+        max_lag = std::max(max_lag, publisher.get_published() - publisher.get_applied());
+    }
+    publisher.close();
+    standby.join();
+
+    EXPECT_FALSE(promoted);
+    EXPECT_LE(max_lag, publisher.get_capacity());
+    EXPECT_EQ(follower.get_applied(), commands.size());
+    EXPECT_EQ(follower_book.state_hash(), primary.state_hash());
+    EXPECT_EQ(follower_book.get_resting_orders_count(), primary.get_resting_orders_count());
+}
+
+TEST(standby_test, follower_process_promotes_when_heartbeat_stops) {
+    const char* name = "/lob_test_standby_failover";
+    std::vector<Command> commands = compact_flow(5000);
+    StandbyPublisher publisher(name, 1024);
+    ASSERT_TRUE(publisher.is_open());
+
+    int pipe_fds[2];
+    ASSERT_EQ(::pipe(pipe_fds), 0);
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        // Follower process: reports its book's state hash after taking over
+        ::close(pipe_fds[0]);
+        StandbyFollower follower(name);
+        Book book(commands.size());
+        std::uint64_t hash = 0;
+        if (follower.is_open() && follower.follow(book, std::chrono::milliseconds(200))) {
+            hash = book.state_hash();
+        }
+        ssize_t written = ::write(pipe_fds[1], &hash, sizeof(hash));
+        ::_exit(written == sizeof(hash) ? 0 : 1);
+    }
+    ::close(pipe_fds[1]);
+    while (!publisher.is_follower_attached()) {
+        publisher.heartbeat();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    CommandRing ingress(64);
+    ExecutionRing egress(1 << 16);
+    EngineRunner runner(ingress, egress);
+    runner.attach_standby(&publisher);
+    runner.start();
+    for (const Command& c : commands) ingress.push(c);
+    runner.stop();
+    // The primary "fails": live again, then no more heartbeats, stream not closed
+    publisher.resume();
+
+    std::uint64_t follower_hash = 0;
+    EXPECT_EQ(::read(pipe_fds[0], &follower_hash, sizeof(follower_hash)),
+              static_cast<ssize_t>(sizeof(follower_hash)));
+    ::close(pipe_fds[0]);
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    EXPECT_EQ(publisher.get_published(), commands.size());
+    EXPECT_EQ(publisher.get_applied(), commands.size());
+    EXPECT_TRUE(publisher.is_fenced());
+    EXPECT_EQ(follower_hash, runner.get_book().state_hash());
+}
+
+TEST(standby_test, stalled_follower_is_dropped) {
+    const char* name = "/lob_test_standby_stalled";
+    StandbyPublisher publisher(name, 16, std::chrono::milliseconds(20));
+    StandbyFollower follower(name);
+    ASSERT_TRUE(follower.is_open());
+
+    Command command{};
+    command.type = CMD_NEW;
+    command.side = BUY;
+    command.price = 100;
+    command.volume = 1;
+    for (ID id = 1; id <= 16; ++id) {
+        command.order_id = id;
+        ASSERT_TRUE(publisher.publish(command));
+    }
+    // Ring full and the follower never polls: dropped after the timeout
+    command.order_id = 17;
+    EXPECT_FALSE(publisher.publish(command));
+    EXPECT_FALSE(publisher.is_replicating());
+    EXPECT_EQ(follower.get_primary_state(), STANDBY_DROPPED);
+
+    Book book;
+    EXPECT_FALSE(follower.promote(book));
+    EXPECT_FALSE(publisher.is_fenced());
+}
+
+TEST(standby_test, promotion_fences_live_runner) {
+    const char* name = "/lob_test_standby_fence";
+    std::vector<Command> commands = compact_flow(2000);
+    StandbyPublisher publisher(name, 4096);
+    ASSERT_TRUE(publisher.is_open());
+    StandbyFollower follower(name);
+    ASSERT_TRUE(follower.is_open());
+
+    CommandRing ingress(2048);   // holds what the fenced runner leaves
+    ExecutionRing egress(1 << 16);
+    EngineRunner runner(ingress, egress);
+    runner.attach_standby(&publisher);
+    runner.start();
+    for (size_t i = 0; i < 1000; ++i) ingress.push(commands[i]);
+    while (runner.get_processed() != 1000) std::this_thread::yield();
+
+    // The follower takes over while the primary is still running
+    Book follower_book(commands.size());
+    ASSERT_TRUE(follower.promote(follower_book));
+    EXPECT_EQ(follower.get_applied(), 1000);
+
+    for (size_t i = 1000; i < commands.size(); ++i) ingress.push(commands[i]);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (runner.is_running() && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+    EXPECT_FALSE(runner.is_running());
+    EXPECT_TRUE(runner.is_fenced());
+    runner.stop();
+    runner.start();   // a fenced runner stays down
+    EXPECT_FALSE(runner.is_running());
+
+    // Nothing was applied after the fence and the stream is shut
+    EXPECT_FALSE(publisher.is_replicating());
+    EXPECT_FALSE(publisher.publish(commands[0]));
+    EXPECT_EQ(follower.get_lag(), 1);   // the publish that saw the fence
+    EXPECT_EQ(runner.get_processed(), 1000);
+    EXPECT_EQ(ingress.size(), commands.size() - 1000);
+    EXPECT_EQ(runner.get_book().state_hash(), follower_book.state_hash());
+}
+
+TEST(standby_test, fence_leaves_rest_of_batch_in_ingress) {
+    const char* name = "/lob_test_standby_fence_batch";
+    std::vector<Command> commands = compact_flow(300);
+    StandbyPublisher publisher(name, 1024);
+    StandbyFollower follower(name);
+    ASSERT_TRUE(follower.is_open());
+
+    CommandRing ingress(512);
+    ExecutionRing egress(1 << 12);
+    EngineRunner runner(ingress, egress);
+    runner.attach_standby(&publisher);
+    for (size_t i = 0; i < 100; ++i) ingress.push(commands[i]);
+    runner.start();
+    runner.stop();
+    ASSERT_EQ(runner.get_processed(), 100);
+
+    // A full batch is waiting when the runner first publishes after the fence
+    for (size_t i = 100; i < commands.size(); ++i) ingress.push(commands[i]);
+    Book follower_book(commands.size());
+    ASSERT_TRUE(follower.promote(follower_book));
+    runner.start();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (runner.is_running() && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+    runner.stop();
+
+    EXPECT_TRUE(runner.is_fenced());
+    EXPECT_EQ(runner.get_processed(), 100);
+    ASSERT_EQ(ingress.size(), commands.size() - 100);
+    Command next{};
+    ASSERT_TRUE(ingress.try_pop(next));
+    EXPECT_EQ(next.order_id, commands[100].order_id);
+    EXPECT_EQ(runner.get_book().state_hash(), follower_book.state_hash());
+}
+
+TEST(standby_test, stopped_runner_pauses_instead_of_failing_over) {
+    const char* name = "/lob_test_standby_pause";
+    std::vector<Command> commands = compact_flow(2000);
+    StandbyPublisher publisher(name, 4096);
+    StandbyFollower follower(name);
+    ASSERT_TRUE(follower.is_open());
+
+    Book follower_book(commands.size());
+    bool promoted = true;
+    std::thread standby([&] { promoted = follower.follow(follower_book, std::chrono::milliseconds(20)); });
+
+    CommandRing ingress(2048);
+    ExecutionRing egress(1 << 16);
+    EngineRunner runner(ingress, egress);
+    runner.attach_standby(&publisher);
+    runner.start();
+    for (size_t i = 0; i < 1000; ++i) ingress.push(commands[i]);
+    runner.stop();   // on purpose, without close()
+
+    // Silent for many times the follower's timeout: paused, not failed
+    EXPECT_EQ(follower.get_primary_state(), STANDBY_PAUSED);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_FALSE(publisher.is_fenced());
+    EXPECT_TRUE(publisher.is_replicating());
+
+    // Restarting goes live again and replication carries on
+    runner.start();
+    for (size_t i = 1000; i < commands.size(); ++i) ingress.push(commands[i]);
+    runner.stop();
+    publisher.close();
+    standby.join();
+
+    EXPECT_FALSE(promoted);
+    EXPECT_FALSE(runner.is_fenced());
+    EXPECT_EQ(runner.get_processed(), commands.size());
+    EXPECT_EQ(follower.get_applied(), commands.size());
+    EXPECT_EQ(follower_book.state_hash(), runner.get_book().state_hash());
+}
+
+// ITCH 5.0 Tests
+static Volume itch_remaining(ItchBook& book, ID order_ref) {
+    auto it = book.get_id_to_order().find(order_ref);
+    return it == book.get_id_to_order().end() ? 0 : it->second->get_remaining_volume();
+}
+
+TEST(itch_test, reconstructs_books_per_locate) {
+    ItchWriter writer;
+    writer.stock_directory(7, 1000, "AAPL");
+    writer.stock_directory(9, 1000, "MSFT");
+    writer.system_event(1500, 'Q');
+    writer.add_order(7, 2000, 1, BUY, 300, "AAPL", 1500000);
+    writer.add_order(7, 2001, 2, BUY, 200, "AAPL", 1500000);
+    writer.add_order(7, 2002, 3, SELL, 100, "AAPL", 1501000);
+    writer.add_order(9, 2003, 4, SELL, 500, "MSFT", 3000000);
+    writer.add_order(7, 2004, 5, SELL, 400, "AAPL", 1499000);   // crosses: the feed never matches
+    writer.order_executed(7, 3000, 1, 100, 42);
+    writer.order_cancel(7, 3001, 2, 50);
+    writer.order_delete(7, 3002, 5);
+    writer.order_replace(9, 3003, 4, 6, 250, 2990000);
+    writer.order_executed(7, 3004, 3, 100, 43);                   // fully executed
+    writer.order_delete(7, 3005, 99);                             // unknown reference
+    const std::vector<unsigned char>& bytes = writer.get_buffer();
+
+    ItchBookBuilder builder;
+    ItchParseStats stats = parse_itch(bytes.data(), bytes.size(), builder);
+    EXPECT_EQ(stats.messages, 14);
+    EXPECT_EQ(stats.bytes, bytes.size());
+    EXPECT_EQ(stats.by_type['A'], 5);
+    EXPECT_EQ(stats.by_type['S'], 1);
+    EXPECT_EQ(stats.first_timestamp, 1000);
+    EXPECT_EQ(stats.last_timestamp, 3005);
+    EXPECT_FALSE(stats.truncated);
+    EXPECT_EQ(stats.malformed, 0);
+
+    EXPECT_EQ(builder.get_book_count(), 2);
+    EXPECT_EQ(builder.get_symbol(7), "AAPL");
+    EXPECT_EQ(builder.get_symbol(9), "MSFT");
+    EXPECT_EQ(builder.get_book(8), nullptr);
+    EXPECT_EQ(builder.get_unknown_orders(), 1);
+
+    ItchBook& aapl = *builder.get_book(7);
+    EXPECT_EQ(aapl.get_resting_orders_count(), 2);
+    EXPECT_EQ(aapl.get_best_buy(), 1500000);
+    EXPECT_EQ(aapl.get_sell_levels_count(), 0);
+    EXPECT_EQ(aapl.get_last_trade_price(), 0);
+    EXPECT_EQ(itch_remaining(aapl, 1), 200);
+    EXPECT_EQ(itch_remaining(aapl, 2), 150);
+
+    ItchBook& msft = *builder.get_book(9);
+    EXPECT_EQ(msft.get_resting_orders_count(), 1);
+    EXPECT_EQ(msft.get_best_sell(), 2990000);
+    EXPECT_EQ(itch_remaining(msft, 6), 250);
+}
+
+TEST(itch_test, execution_keeps_queue_priority) {
+    ItchWriter writer;
+    writer.add_order(1, 1, 10, BUY, 500, "X", 10000);
+    writer.add_order(1, 2, 11, BUY, 500, "X", 10000);
+    writer.order_executed(1, 3, 10, 200, 1);
+    writer.order_replace(1, 4, 11, 12, 500, 10000);   // replace loses priority
+    writer.add_order(1, 5, 13, BUY, 100, "X", 10000);
+
+    ItchBookBuilder builder;
+    const std::vector<unsigned char>& bytes = writer.get_buffer();
+    parse_itch(bytes.data(), bytes.size(), builder);
+
+    const Level& level = *builder.get_book(1)->get_buy_limits().find(10000)->second;
+    std::vector<ID> queue;
+    for (const Order* o = level.get_head(); o; o = o->get_next_order()) queue.push_back(o->get_order_id());
+    EXPECT_EQ(queue, (std::vector<ID>{10, 12, 13}));
+    EXPECT_EQ(level.get_total_volume(), 900);
+}
+
+TEST(itch_test, maps_file_and_stops_at_truncated_tail) {
+    ItchWriter writer;
+    for (ID ref = 1; ref <= 100; ++ref) {
+        writer.add_order(3, ref, ref, (ref % 2) ? BUY : SELL, 100, "ABC", (ref % 2) ? 9000 : 11000);
+    }
+    std::vector<unsigned char> bytes = writer.get_buffer();
+    bytes.resize(bytes.size() - 5);   // cut inside the last message
+    std::string path = journal_path("lob_itch_capture.itch");
+    ASSERT_TRUE(write_file_atomically(path.c_str(), bytes.data(), bytes.size()));
+
+    {
+        ItchFile file(path.c_str());
+        ASSERT_TRUE(file.is_open());
+        ItchBookBuilder builder;
+        ItchParseStats stats = file.parse(builder);
+        EXPECT_TRUE(stats.truncated);
+        EXPECT_EQ(stats.messages, 99);
+        EXPECT_EQ(builder.get_resting_orders_count(), 99);
+    }
+    std::remove(path.c_str());
+    EXPECT_FALSE(ItchFile(path.c_str()).is_open());
+}
+
+#if LOB_ENABLE_STP
+// Self-Trade Prevention Tests
+TEST(stp_test, disabled_by_default_allows_self_match) {
+    Book book;
+
+    book.place_order(1, 7, BUY, 100, 10);
+    const Trades& trades = book.place_order(2, 7, SELL, 100, 10);
+
+    EXPECT_EQ(trades.size(), 1);
+    EXPECT_EQ(book.get_resting_orders_count(), 0);
+}
+
+TEST(stp_test, cancel_newest) {
+    Book book;
+    book.set_stp_mode(STP_CANCEL_NEWEST);
+
+    book.place_order(1, 7, BUY, 100, 10);
+    const Trades& trades = book.place_order(2, 7, SELL, 100, 10);
+
+    EXPECT_EQ(trades.size(), 0);
+    EXPECT_EQ(book.get_order_status(1), ACTIVE);
+    EXPECT_EQ(book.get_order_status(2), DELETED);
+    EXPECT_EQ(book.get_sell_levels_count(), 0);
+}
+
+TEST(stp_test, cancel_oldest_keeps_matching) {
+    Book book;
+    book.set_stp_mode(STP_CANCEL_OLDEST);
+
+    book.place_order(1, 7, BUY, 100, 10);
+    book.place_order(2, 8, BUY, 100, 10);
+    const Trades& trades = book.place_order(3, 7, SELL, 100, 15);
+
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].get_matched_order(), 2);
+    EXPECT_EQ(trades[0].get_trade_volume(), 10);
+    EXPECT_EQ(book.get_order_status(1), DELETED);
+    EXPECT_EQ(book.get_best_sell(), 100);
+    EXPECT_EQ(book.get_buy_levels_count(), 0);
+}
+
+TEST(stp_test, cancel_both) {
+    Book book;
+    book.set_stp_mode(STP_CANCEL_BOTH);
+
+    book.place_order(1, 7, BUY, 100, 10);
+    book.place_order(2, 8, BUY, 100, 10);
+    const Trades& trades = book.place_order(3, 7, SELL, 100, 15);
+
+    EXPECT_EQ(trades.size(), 0);
+    EXPECT_EQ(book.get_order_status(1), DELETED);
+    EXPECT_EQ(book.get_order_status(2), ACTIVE);
+    EXPECT_EQ(book.get_sell_levels_count(), 0);
+}
+
+TEST(stp_test, decrement_reduces_both_without_trade) {
+    Book book;
+    book.set_stp_mode(STP_DECREMENT);
+
+    book.place_order(1, 7, BUY, 100, 10);
+    book.place_order(2, 8, BUY, 100, 10);
+    const Trades& trades = book.place_order(3, 7, SELL, 100, 15);
+
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].get_matched_order(), 2);
+    EXPECT_EQ(trades[0].get_trade_volume(), 5);
+    EXPECT_EQ(book.get_order_status(1), DELETED);
+    EXPECT_EQ(book.get_order_status(2), ACTIVE);
+    EXPECT_EQ(book.get_resting_orders_count(), 1);
+}
+#endif
+
 // Main function
 int main(int argc, char **argv) {
 	testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,302 @@
+// LOBReplay: deterministic replay of a recorded journal or message file.
+//
+//   LOBReplay <input> [--expect <event-hash>]
+//   LOBReplay --generate <journal> <count> [seed]
+//   LOBReplay --compact <journal> <compact-journal>
+//
+// <input> is a Journal file, a compact journal (recognised by its header
+// magic) or a text message file with one command per line:
+//   N <order_id> <agent_id> <B|S> <price> <volume>
+//   C <order_id>
+//   A <order_id> <price> <volume>
+//
+// The input is loaded into memory first, then replayed twice on fresh books:
+// once untimed per message (throughput) and once timing every message
+// (latency distribution). Both runs must produce the same event hash; with
+// --expect, a different hash makes the run fail, which is how an engine
+// change is qualified as bit-identical.
+//
+// A compact journal is additionally decoded on its own and replayed straight
+// from its blocks (decode + match, no command vector), so decode cost can be
+// set against matching cost; that run must produce the same hash too.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "LOB/Book.h"
+#include "LOB/CompactJournal.h"
+#include "LOB/EngineRunner.h"
+#include "LOB/EventHash.h"
+#include "LOB/Journal.h"
+
+using namespace std::chrono;
+
+using ReplayBook = BasicBook<FifoMatching, EventHashSink>;
+
+namespace {
+
+bool read_messages(const char* path, std::vector<Command>& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream fields(line);
+        char kind = 0;
+        fields >> kind;
+        Command command{};
+        bool ok = false;
+        if (kind == 'N') {
+            char side = 0;
+            command.type = CMD_NEW;
+            ok = static_cast<bool>(fields >> command.order_id >> command.agent_id >> side
+                                          >> command.price >> command.volume)
+                 && (side == 'B' || side == 'S');
+            command.side = (side == 'B') ? BUY : SELL;
+        } else if (kind == 'C') {
+            command.type = CMD_CANCEL;
+            ok = static_cast<bool>(fields >> command.order_id);
+        } else if (kind == 'A') {
+            command.type = CMD_AMEND;
+            ok = static_cast<bool>(fields >> command.order_id >> command.price >> command.volume);
+        }
+        if (!ok) {
+            std::cerr << path << ":" << line_number << ": malformed message" << std::endl;
+            return false;
+        }
+        out.push_back(command);
+    }
+    return true;
+}
+
+// Synthetic flow around a 10000 mid: 70% new, 20% cancel, 10% amend
+bool generate(const char* path, size_t count, unsigned seed) {
+    std::remove(path);
+    Journal journal(path, count);
+    if (!journal.is_open()) return false;
+
+    std::mt19937_64 rng(seed);
+    std::vector<ID> live;
+    live.reserve(count);
+    ID next_id = 1;
+    for (size_t i = 0; i < count; ++i) {
+        Command command{};
+        unsigned roll = rng() % 10;
+        if (roll < 7 || live.empty()) {
+            command.type = CMD_NEW;
+            command.order_id = next_id++;
+            command.agent_id = 1 + rng() % 1000;
+            command.side = (rng() & 1) ? BUY : SELL;
+            command.price = static_cast<PRICE>(9990 + rng() % 21);
+            command.volume = 1 + rng() % 1000;
+            live.push_back(command.order_id);
+        } else {
+            size_t pick = rng() % live.size();
+            command.order_id = live[pick];
+            if (roll < 9) {
+                command.type = CMD_CANCEL;
+                live[pick] = live.back();
+                live.pop_back();
+            } else {
+                command.type = CMD_AMEND;
+                command.price = static_cast<PRICE>(9990 + rng() % 21);
+                command.volume = 1 + rng() % 1000;
+            }
+        }
+        journal.append(command);
+    }
+    journal.stop();
+    return true;
+}
+
+// Re-encodes a Journal (e.g. one written by EngineRunner) as a compact journal
+bool compact(const char* journal_path, const char* compact_path, size_t& count) {
+    std::vector<Command> commands;
+    if (!read_journal(journal_path, commands)) return false;
+    CompactJournalWriter writer(compact_path);
+    if (!writer.is_open()) return false;
+    for (const Command& command : commands) {
+        if (!writer.append(command)) return false;
+    }
+    count = commands.size();
+    return writer.close();
+}
+
+struct RunResult {
+    std::uint64_t event_hash;
+    std::uint64_t events;
+    std::uint64_t state_hash;
+    double seconds;
+};
+
+RunResult replay_throughput(const std::vector<Command>& commands) {
+    ReplayBook book(commands.size());
+    auto start = steady_clock::now();
+    for (const Command& command : commands) {
+        apply_command(book, command);
+    }
+    auto end = steady_clock::now();
+    const EventHashSink& sink = book.get_event_sink();
+    return RunResult{sink.get_hash(), sink.get_event_count(), book.state_hash(),
+                     duration<double>(end - start).count()};
+}
+
+RunResult replay_latency(const std::vector<Command>& commands, std::vector<std::uint32_t>& latencies) {
+    ReplayBook book(commands.size());
+    latencies.resize(commands.size());
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < commands.size(); ++i) {
+        auto t0 = steady_clock::now();
+        apply_command(book, commands[i]);
+        auto t1 = steady_clock::now();
+        auto ns = duration_cast<nanoseconds>(t1 - t0).count();
+        latencies[i] = static_cast<std::uint32_t>(std::min<long long>(ns, UINT32_MAX));
+    }
+    auto end = steady_clock::now();
+    const EventHashSink& sink = book.get_event_sink();
+    return RunResult{sink.get_hash(), sink.get_event_count(), book.state_hash(),
+                     duration<double>(end - start).count()};
+}
+
+// Decode only: the cost the compact format adds in front of matching
+double decode_seconds(const CompactJournalReader& reader) {
+    Volume checksum = 0;
+    auto start = steady_clock::now();
+    reader.replay([&checksum](const Command& command) { checksum += command.volume; });
+    auto end = steady_clock::now();
+    volatile Volume sink = checksum;
+    (void)sink;
+    return duration<double>(end - start).count();
+}
+
+// Decode + match straight from the blocks
+RunResult replay_compact(const CompactJournalReader& reader) {
+    ReplayBook book(reader.get_record_count());
+    auto start = steady_clock::now();
+    reader.replay([&book](const Command& command) { apply_command(book, command); });
+    auto end = steady_clock::now();
+    const EventHashSink& sink = book.get_event_sink();
+    return RunResult{sink.get_hash(), sink.get_event_count(), book.state_hash(),
+                     duration<double>(end - start).count()};
+}
+
+void print_hash(const char* label, std::uint64_t hash) {
+    std::printf("  %-22s %016" PRIx64 "\n", label, hash);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && std::strcmp(argv[1], "--generate") == 0) {
+        size_t count = std::strtoull(argv[3], nullptr, 10);
+        unsigned seed = argc > 4 ? static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10)) : 1;
+        if (count == 0 || !generate(argv[2], count, seed)) {
+            std::cerr << "cannot write " << argv[2] << std::endl;
+            return 2;
+        }
+        std::cout << "Wrote " << count << " commands to " << argv[2] << std::endl;
+        return 0;
+    }
+    if (argc >= 4 && std::strcmp(argv[1], "--compact") == 0) {
+        size_t count = 0;
+        if (!compact(argv[2], argv[3], count)) {
+            std::cerr << "cannot convert " << argv[2] << " to " << argv[3] << std::endl;
+            return 2;
+        }
+        std::cout << "Wrote " << count << " commands to " << argv[3] << std::endl;
+        return 0;
+    }
+    if (argc < 2) {
+        std::cerr << "usage: LOBReplay <journal|compact-journal|messages> [--expect <event-hash>]\n"
+                  << "       LOBReplay --generate <journal> <count> [seed]\n"
+                  << "       LOBReplay --compact <journal> <compact-journal>" << std::endl;
+        return 2;
+    }
+
+    bool expect = false;
+    std::uint64_t expected_hash = 0;
+    if (argc >= 4 && std::strcmp(argv[2], "--expect") == 0) {
+        expect = true;
+        expected_hash = std::strtoull(argv[3], nullptr, 16);
+    }
+
+    std::vector<Command> commands;
+    const char* format = "journal";
+    CompactJournalReader compact_reader(argv[1]);
+    if (compact_reader.is_open()) {
+        format = "compact journal";
+        commands.reserve(compact_reader.get_record_count());
+        compact_reader.replay([&commands](const Command& command) { commands.push_back(command); });
+    } else if (!read_journal(argv[1], commands)) {
+        format = "messages";
+        commands.clear();
+        if (!read_messages(argv[1], commands)) {
+            std::cerr << "cannot read " << argv[1] << std::endl;
+            return 2;
+        }
+    }
+    if (commands.empty()) {
+        std::cerr << argv[1] << ": no commands" << std::endl;
+        return 2;
+    }
+
+    RunResult fast = replay_throughput(commands);
+    std::vector<std::uint32_t> latencies;
+    RunResult timed = replay_latency(commands, latencies);
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+    };
+
+    std::printf("--- Replay of %s (%s) ---\n", argv[1], format);
+    std::printf("  %-22s %zu\n", "Messages:", commands.size());
+    std::printf("  %-22s %.3f s\n", "Elapsed:", fast.seconds);
+    std::printf("  %-22s %.2f M msgs/sec\n", "Throughput:", commands.size() / fast.seconds / 1e6);
+    std::printf("  Latency (ns, timed run):\n");
+    std::printf("    p50 %u  p90 %u  p99 %u  p99.9 %u  p99.99 %u  max %u\n",
+                percentile(0.50), percentile(0.90), percentile(0.99),
+                percentile(0.999), percentile(0.9999), latencies.back());
+    std::printf("  %-22s %" PRIu64 "\n", "Events:", fast.events);
+    print_hash("Event hash:", fast.event_hash);
+    print_hash("Final state hash:", fast.state_hash);
+
+    if (compact_reader.is_open()) {
+        double decode = decode_seconds(compact_reader);
+        RunResult streamed = replay_compact(compact_reader);
+        std::printf("  Compact journal:\n");
+        std::printf("    %-20s %.2f bytes/msg (vs %zu)\n", "Size:",
+                    static_cast<double>(compact_reader.get_file_bytes()) / commands.size(), sizeof(JournalRecord));
+        std::printf("    %-20s %.2f M msgs/sec\n", "Decode only:", commands.size() / decode / 1e6);
+        std::printf("    %-20s %.2f M msgs/sec (decode %.0f%%)\n", "Decode + match:",
+                    commands.size() / streamed.seconds / 1e6, 100.0 * decode / streamed.seconds);
+        if (streamed.event_hash != fast.event_hash || streamed.state_hash != fast.state_hash) {
+            std::printf("  NON-DETERMINISTIC: compact run produced %016" PRIx64 "\n", streamed.event_hash);
+            return 1;
+        }
+    }
+
+    if (timed.event_hash != fast.event_hash || timed.state_hash != fast.state_hash) {
+        std::printf("  NON-DETERMINISTIC: timed run produced %016" PRIx64 "\n", timed.event_hash);
+        return 1;
+    }
+    if (expect) {
+        bool match = (fast.event_hash == expected_hash);
+        std::printf("  %-22s %s\n", "Expected hash:", match ? "match" : "MISMATCH");
+        return match ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+// LOBStandby: primary / hot-standby pair over a shared-memory command stream.
+//
+//   LOBStandby --follow <shm-name> [timeout_ms]
+//   LOBStandby --primary <shm-name> <journal> [--crash]
+//
+// The primary creates the region, waits for a follower to attach, then
+// publishes and applies every command of the journal. It closes the stream
+// cleanly at the end, or with --crash exits without closing so its
+// heartbeat simply stops. The follower applies the stream to its own book
+// and, once the primary has been silent for timeout_ms (default 100), takes
+// over after draining the ring. Both print the final state hash, which must
+// match.
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "LOB/Book.h"
+#include "LOB/EngineRunner.h"
+#include "LOB/Journal.h"
+#include "LOB/Standby.h"
+
+using namespace std::chrono;
+
+namespace {
+
+int run_primary(const char* name, const char* journal_path, bool crash) {
+    std::vector<Command> commands;
+    if (!read_journal(journal_path, commands) || commands.empty()) {
+        std::cerr << "cannot read " << journal_path << std::endl;
+        return 2;
+    }
+    // Allocate up front: once the region exists the heartbeat must not pause
+    Book book(commands.size());
+    StandbyPublisher publisher(name);
+    if (!publisher.is_open()) {
+        std::cerr << "cannot create " << name << std::endl;
+        return 2;
+    }
+    std::printf("Primary: waiting for a follower on %s\n", name);
+    while (!publisher.is_follower_attached()) {
+        publisher.heartbeat();
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < commands.size(); ++i) {
+        if (!publisher.publish(commands[i]) && publisher.is_fenced()) {
+            std::cerr << "fenced: the follower has promoted" << std::endl;
+            return 1;
+        }
+        apply_command(book, commands[i]);
+        if ((i & 63) == 0) publisher.heartbeat();
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    std::printf("  %-22s %zu\n", "Published:", commands.size());
+    std::printf("  %-22s %.2f M msgs/sec\n", "Throughput:", commands.size() / seconds / 1e6);
+    std::printf("  %-22s %" PRIu64 "\n", "Follower behind by:", publisher.get_published() - publisher.get_applied());
+    std::printf("  %-22s %016" PRIx64 "\n", "Final state hash:", book.state_hash());
+    std::fflush(stdout);
+    if (crash) {
+        // No close(), no unlink: the follower sees the heartbeat stop
+        std::_Exit(0);
+    }
+    return 0;
+}
+
+int run_follower(const char* name, milliseconds timeout) {
+    // The primary may not have created the region yet
+    auto give_up = steady_clock::now() + seconds(10);
+    std::unique_ptr<StandbyFollower> follower;
+    for (;;) {
+        follower = std::make_unique<StandbyFollower>(name);
+        if (follower->is_open()) break;
+        if (steady_clock::now() > give_up) {
+            std::cerr << "cannot attach to " << name << std::endl;
+            return 2;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+
+    Book book(1 << 20);
+    std::uint64_t max_lag = 0;
+    unsigned idle_rounds = 0;
+    for (;;) {
+        max_lag = std::max(max_lag, follower->get_lag());
+        if (follower->poll(book) != 0) {
+            idle_rounds = 0;
+            continue;
+        }
+        std::uint32_t state = follower->get_primary_state();
+        if (state == STANDBY_CLOSED || state == STANDBY_DROPPED) {
+            while (follower->poll(book) != 0) {}
+            std::printf("Follower: primary %s\n", state == STANDBY_CLOSED ? "closed" : "dropped this follower");
+            break;
+        }
+        if (follower->primary_failed(timeout)) {
+            std::uint64_t backlog = follower->get_lag();
+            auto t0 = steady_clock::now();
+            bool promoted = follower->promote(book);
+            auto drain_us = duration_cast<microseconds>(steady_clock::now() - t0).count();
+            std::printf("Follower: primary silent for %lld ms, %s\n", static_cast<long long>(timeout.count()),
+                        promoted ? "promoted" : "cannot promote");
+            std::printf("  %-22s %" PRIu64 " commands in %lld us\n", "Failover drain:", backlog,
+                        static_cast<long long>(drain_us));
+            break;
+        }
+        idle_wait(WAIT_BACKOFF, idle_rounds++);
+    }
+
+    std::printf("  %-22s %" PRIu64 "\n", "Applied:", follower->get_applied());
+    std::printf("  %-22s %" PRIu64 "\n", "Max lag:", max_lag);
+    std::printf("  %-22s %016" PRIx64 "\n", "Final state hash:", book.state_hash());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && std::strcmp(argv[1], "--follow") == 0) {
+        long timeout_ms = argc > 3 ? std::strtol(argv[3], nullptr, 10) : 100;
+        return run_follower(argv[2], milliseconds(timeout_ms > 0 ? timeout_ms : 100));
+    }
+    if (argc >= 4 && std::strcmp(argv[1], "--primary") == 0) {
+        bool crash = argc > 4 && std::strcmp(argv[4], "--crash") == 0;
+        return run_primary(argv[2], argv[3], crash);
+    }
+    std::cerr << "usage: LOBStandby --follow <shm-name> [timeout_ms]\n"
+              << "       LOBStandby --primary <shm-name> <journal> [--crash]" << std::endl;
+    return 2;
+}